@@ -170,3 +170,28 @@ function about_modules()
         end
     end
 end
+
+function lua_profiler_start(interval)
+    if g_app.isLuaProfiling() then
+        pcolored('ERROR: the lua profiler is already running', 'red')
+        return
+    end
+
+    g_app.startLuaProfiler(interval or 1000)
+    pcolored('Lua profiler started', 'green')
+end
+
+function lua_profiler_stop(file)
+    if not g_app.isLuaProfiling() then
+        pcolored('ERROR: the lua profiler is not running', 'red')
+        return
+    end
+
+    file = file or '/lua_profile.folded'
+    g_app.stopLuaProfiler()
+    if g_app.saveLuaProfile(file) then
+        pcolored('Lua profile saved to ' .. file .. ' (folded stacks, in microseconds)', 'green')
+    else
+        pcolored('ERROR: unable to save the lua profile to ' .. file, 'red')
+    end
+end
@@ -0,0 +1,52 @@
+-- @docclass UIVirtualList
+function UIVirtualList:onStyleApply(styleName, styleNode)
+    for name, value in pairs(styleNode) do
+        if name == 'vertical-scrollbar' then
+            addEvent(function()
+                local parent = self:getParent()
+                if parent then
+                    self:setVerticalScrollBar(parent:getChildById(value))
+                end
+            end)
+        end
+    end
+end
+
+function UIVirtualList:setVerticalScrollBar(scrollbar)
+    self.verticalScrollBar = scrollbar
+    if not scrollbar then return end
+
+    connect(scrollbar, 'onValueChange', function(scrollbar, value)
+        if self.verticalScrollBar == scrollbar then
+            self:setScrollOffset(value)
+        end
+    end)
+
+    if not self.scrollBarConnected then
+        self.scrollBarConnected = true
+        connect(self, {
+            onScrollChange = function(self, offset)
+                if self.verticalScrollBar then
+                    self.verticalScrollBar:setValue(offset)
+                end
+            end,
+            onScrollRangeChange = function(self, maximum)
+                if self.verticalScrollBar then
+                    self.verticalScrollBar:setRange(0, maximum)
+                end
+            end
+        })
+    end
+
+    self:updateScrollBar()
+end
+
+function UIVirtualList:getVerticalScrollBar() return self.verticalScrollBar end
+
+function UIVirtualList:updateScrollBar()
+    local scrollbar = self.verticalScrollBar
+    if scrollbar then
+        scrollbar:setRange(0, self:getMaxScrollOffset())
+        scrollbar:setValue(self:getScrollOffset())
+    end
+end
@@ -55,6 +55,7 @@ class Spawn;
 class TileBlock;
 
 struct Highlight;
+struct StaticItem;
 struct AwareRange;
 
 using MapViewPtr = stdext::shared_object_ptr<MapView>;
@@ -146,7 +146,7 @@ void Map::loadOtbm(const std::string& fileName)
                         }
                         case OTBM_ATTR_ITEM:
                         {
-                            addThing(Item::createFromOtb(nodeTile->getU16()), pos);
+                            addLoadedItem(Item::createFromOtb(nodeTile->getU16()), pos);
                             break;
                         }
                         default:
@@ -180,7 +180,7 @@ void Map::loadOtbm(const std::string& fileName)
                             item.reset();
                         }
 
-                        addThing(item, pos);
+                        addLoadedItem(item, pos);
                     }
 
                     if(const TilePtr& tile = getTile(pos)) {
@@ -457,7 +457,7 @@ bool Map::loadOtcm(const std::string& fileName)
                 item->setCountOrSubType(countOrSubType);
 
                 if(item->isValid())
-                    tile->addThing(item, ++stackPos);
+                    addLoadedItem(item, pos, ++stackPos);
             }
 
             g_map.notificateTileUpdate(pos);
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <client/map/lightgrid.h>
+
+#include <framework/graphics/image.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHTGRID_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // the light texture of the textured renderer squares the intensity and boosts it by 30%
+    constexpr float lightBoost = 1.3f;
+
+    struct LightKernel
+    {
+        float centerX, distanceY2, radius, invRadius, alpha, red, green, blue;
+    };
+
+    // same operations in the same order as the vector kernel, so both give the same grid
+    void blendRowScalar(float* red, float* green, float* blue, int begin, int end, const LightKernel& k)
+    {
+        for(int x = begin; x < end; ++x) {
+            const float dx = (x + .5f) - k.centerX;
+            const float distance = std::sqrt(dx * dx + k.distanceY2);
+            const float intensity = std::min<float>(std::max<float>((k.radius - distance) * k.invRadius, 0.f), 1.f);
+            const float alpha = std::min<float>(intensity * intensity * lightBoost, 1.f) * k.alpha;
+
+            red[x] += (k.red - red[x]) * alpha;
+            green[x] += (k.green - green[x]) * alpha;
+            blue[x] += (k.blue - blue[x]) * alpha;
+        }
+    }
+
+#ifdef LIGHTGRID_SSE2
+    inline void blend(float* channel, __m128 color, __m128 alpha)
+    {
+        const __m128 value = _mm_loadu_ps(channel);
+        _mm_storeu_ps(channel, _mm_add_ps(value, _mm_mul_ps(_mm_sub_ps(color, value), alpha)));
+    }
+
+    // begin and end are multiples of 4, rows are padded for it
+    void blendRowSse2(float* red, float* green, float* blue, int begin, int end, const LightKernel& k)
+    {
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f), step = _mm_set1_ps(4.f), boost = _mm_set1_ps(lightBoost);
+        const __m128 centerX = _mm_set1_ps(k.centerX), distanceY2 = _mm_set1_ps(k.distanceY2);
+        const __m128 radius = _mm_set1_ps(k.radius), invRadius = _mm_set1_ps(k.invRadius), lightAlpha = _mm_set1_ps(k.alpha);
+        const __m128 lightRed = _mm_set1_ps(k.red), lightGreen = _mm_set1_ps(k.green), lightBlue = _mm_set1_ps(k.blue);
+
+        __m128 x = _mm_add_ps(_mm_setr_ps(begin, begin + 1, begin + 2, begin + 3), _mm_set1_ps(.5f));
+        for(int i = begin; i < end; i += 4, x = _mm_add_ps(x, step)) {
+            const __m128 dx = _mm_sub_ps(x, centerX);
+            const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), distanceY2));
+            const __m128 intensity = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(radius, distance), invRadius), zero), one);
+            const __m128 alpha = _mm_mul_ps(_mm_min_ps(_mm_mul_ps(_mm_mul_ps(intensity, intensity), boost), one), lightAlpha);
+
+            blend(red + i, lightRed, alpha);
+            blend(green + i, lightGreen, alpha);
+            blend(blue + i, lightBlue, alpha);
+        }
+    }
+#endif
+
+    using BlendRowFunction = void(*)(float*, float*, float*, int, int, const LightKernel&);
+
+    // set by selfCheck when the vector kernel disagrees with the scalar one on this cpu
+#ifdef LIGHTGRID_SSE2
+    BlendRowFunction blendRow = blendRowSse2;
+#else
+    BlendRowFunction blendRow = blendRowScalar;
+#endif
+
+    // blends a few lights over rows with varied values using both kernels, results may only
+    // differ by rounding (the compiler is free to contract the scalar one)
+    bool checkKernel(BlendRowFunction kernel)
+    {
+        constexpr int cells = 64;
+        const LightKernel lights[] = {
+            { 32.f, 0.f, 12.f, 1.f / 12.f, 1.f, 1.f, .8f, .4f },
+            { 5.3f, 20.25f, 9.5f, 1.f / 9.5f, .6f, .2f, .9f, 1.f },
+            { 60.7f, 2.f, 40.f, 1.f / 40.f, .35f, .7f, .1f, .5f },
+            { 20.f, 200.f, 3.f, 1.f / 3.f, 1.f, 1.f, 1.f, 1.f }
+        };
+
+        float expected[3][cells], result[3][cells];
+        for(int i = 0; i < cells; ++i) {
+            for(int c = 0; c < 3; ++c)
+                expected[c][i] = result[c][i] = ((i * 7 + c * 13) % 17) / 16.f;
+        }
+
+        for(const LightKernel& k : lights) {
+            blendRowScalar(expected[0], expected[1], expected[2], 0, cells, k);
+            kernel(result[0], result[1], result[2], 0, cells, k);
+        }
+
+        for(int c = 0; c < 3; ++c) {
+            for(int i = 0; i < cells; ++i) {
+                if(std::abs(expected[c][i] - result[c][i]) > 1e-5f)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    inline uint8 toByte(float value) { return static_cast<uint8>(std::min<float>(std::max<float>(value, 0.f), 1.f) * 255.f + .5f); }
+}
+
+void LightGrid::reset(const Size& size, float cellSize, const Color& ambient)
+{
+    m_cellSize = std::max<float>(cellSize, 1.f);
+    m_size = Size(std::ceil(size.width() / m_cellSize), std::ceil(size.height() / m_cellSize));
+    m_stride = (m_size.width() + 3) & ~3;
+
+    const size_t cells = m_stride * m_size.height();
+    m_red.assign(cells, ambient.rF());
+    m_green.assign(cells, ambient.gF());
+    m_blue.assign(cells, ambient.bF());
+}
+
+void LightGrid::addShade(const Rect& rect, const Color& color)
+{
+    // the shade texture is transparent on a border of a tenth of its size, covered cells are the ones
+    // with their center inside the rest
+    const float insetX = rect.width() / 10.f, insetY = rect.height() / 10.f;
+    const auto firstCell = [this](float pos) { return static_cast<int>(std::ceil(pos / m_cellSize - .5f)); };
+
+    const int left = std::max<int>(0, firstCell(rect.left() + insetX)),
+        right = std::min<int>(m_size.width(), firstCell(rect.left() + rect.width() - insetX)),
+        top = std::max<int>(0, firstCell(rect.top() + insetY)),
+        bottom = std::min<int>(m_size.height(), firstCell(rect.top() + rect.height() - insetY));
+
+    const float alpha = color.aF();
+    for(int y = top; y < bottom; ++y) {
+        const size_t row = y * m_stride;
+        for(int x = left; x < right; ++x) {
+            m_red[row + x] += (color.rF() - m_red[row + x]) * alpha;
+            m_green[row + x] += (color.gF() - m_green[row + x]) * alpha;
+            m_blue[row + x] += (color.bF() - m_blue[row + x]) * alpha;
+        }
+    }
+}
+
+void LightGrid::addLight(const Point& center, uint16 radius, const Color& color)
+{
+    if(radius == 0 || color.aF() <= 0.f)
+        return;
+
+    LightKernel kernel;
+    kernel.centerX = center.x / m_cellSize;
+    kernel.radius = radius / m_cellSize;
+    kernel.invRadius = 1.f / kernel.radius;
+    kernel.alpha = color.aF();
+    kernel.red = color.rF();
+    kernel.green = color.gF();
+    kernel.blue = color.bF();
+
+    const float centerY = center.y / m_cellSize;
+    const int top = std::max<int>(0, std::floor(centerY - kernel.radius)),
+        bottom = std::min<int>(m_size.height(), std::ceil(centerY + kernel.radius)),
+        left = std::max<int>(0, std::floor(kernel.centerX - kernel.radius)) & ~3,
+        right = std::min<int>(m_stride, (static_cast<int>(std::ceil(kernel.centerX + kernel.radius)) + 3) & ~3);
+
+    if(left >= right)
+        return;
+
+    for(int y = top; y < bottom; ++y) {
+        const float dy = (y + .5f) - centerY;
+        kernel.distanceY2 = dy * dy;
+
+        const size_t row = y * m_stride;
+        blendRow(&m_red[row], &m_green[row], &m_blue[row], left, right, kernel);
+    }
+}
+
+bool LightGrid::selfCheck()
+{
+    static bool checked = false, ok = true;
+    if(checked)
+        return ok;
+    checked = true;
+
+#ifdef LIGHTGRID_SSE2
+    if(!checkKernel(blendRowSse2)) {
+        g_logger.error("Light grid self check failed for the SSE2 kernel, using the scalar one");
+        blendRow = blendRowScalar;
+        ok = false;
+    }
+#endif
+    return ok;
+}
+
+Color LightGrid::getCell(int x, int y) const
+{
+    const size_t index = y * m_stride + x;
+    return Color(m_red[index], m_green[index], m_blue[index]);
+}
+
+const ImagePtr& LightGrid::toImage()
+{
+    if(!m_image || m_image->getSize() != m_size)
+        m_image = ImagePtr(new Image(m_size));
+
+    uint8* pixel = m_image->getPixelData();
+    for(int y = 0; y < m_size.height(); ++y) {
+        const size_t row = y * m_stride;
+        for(int x = 0; x < m_size.width(); ++x, pixel += 4) {
+            pixel[0] = toByte(m_red[row + x]);
+            pixel[1] = toByte(m_green[row + x]);
+            pixel[2] = toByte(m_blue[row + x]);
+            pixel[3] = 0xff;
+        }
+    }
+
+    return m_image;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include <framework/global.h>
+#include <framework/graphics/declarations.h>
+
+// Software light map: lights and shades are blended on a grid of a few cells per tile,
+// the result is uploaded as a small texture and stretched with smoothing over the map.
+// It gives the same picture as the textured light quads without a GPU, so it can be
+// compared cell by cell.
+class LightGrid
+{
+public:
+    static constexpr int CELLS_PER_TILE = 4;
+
+    // compares the vector kernel with the scalar one, a kernel that disagrees is logged and
+    // replaced by the scalar one, only checks on the first call
+    static bool selfCheck();
+
+    // size is in pixels, the grid covers it with cells of cellSize pixels filled with the ambient light
+    void reset(const Size& size, float cellSize, const Color& ambient);
+
+    void addShade(const Rect& rect, const Color& color);
+    void addLight(const Point& center, uint16 radius, const Color& color);
+
+    Color getCell(int x, int y) const;
+    const Size& getSize() const { return m_size; }
+    float getCellSize() const { return m_cellSize; }
+
+    const ImagePtr& toImage();
+
+private:
+    Size m_size;
+    int m_stride{ 0 };
+    float m_cellSize{ 1.f };
+
+    // one plane per channel, rows padded to a multiple of 4 cells for the vector kernels
+    std::vector<float> m_red, m_green, m_blue;
+
+    ImagePtr m_image;
+};
+
+#endif
@@ -55,6 +55,18 @@ void LightView::setShade(const Point& point)
     m_shades[index] = ShadeBlock{ m_currentFloor, point };
 }
 
+void LightView::setGridEnabled(const bool enable)
+{
+    if(enable == isGridEnabled()) return;
+
+    if(enable)
+        LightGrid::selfCheck();
+
+    m_grid = enable ? std::make_unique<LightGrid>() : nullptr;
+    m_gridTexture = nullptr;
+    update();
+}
+
 void LightView::resize()
 {
     m_lightbuffer->resize(m_mapView->m_frameCache.tile->getSize());
@@ -26,6 +26,7 @@
 #include <framework/graphics/framebuffer.h>
 #include <framework/graphics/declarations.h>
 #include <client/painter/lightviewpainter.h>
+#include <client/map/lightgrid.h>
 #include <client/declarations.h>
 #include <client/thing/type/thingtype.h>
 
@@ -47,6 +48,7 @@ public:
     LightView(const MapViewPtr& mapView);
 
     void resize();
+    void setGridEnabled(bool enable);
 
     void addLightSource(const Point& mainCenter, const Light& light);
 
@@ -57,8 +59,10 @@ public:
     const Light& getGlobalLight() const { return m_globalLight; }
 
     bool canUpdate() const { return isDark() && m_lightbuffer->canUpdate(); }
+    bool hasPendingUpdate() const { return isDark() && m_lightbuffer->hasPendingUpdate(); }
     void update() const { if(isDark()) m_lightbuffer->update(); }
     bool isDark() const { return m_globalLight.intensity < 250; }
+    bool isGridEnabled() const { return m_grid != nullptr; }
 
 private:
 
@@ -73,6 +77,9 @@ private:
     std::vector<ShadeBlock> m_shades;
     std::array<std::vector<LightSource>, MAX_Z + 1> m_lights;
 
+    std::unique_ptr<LightGrid> m_grid;
+    TexturePtr m_gridTexture;
+
     friend class LightViewPainter;
 };
 
@@ -101,6 +101,16 @@ void Map::notificateTileUpdate(const Position& pos)
     g_minimap.updateTile(pos, getTile(pos));
 }
 
+void Map::notificateThingUpdate(const Position& pos)
+{
+    if(!pos.isMapPosition())
+        return;
+
+    for(const MapViewPtr& mapView : m_mapViews) {
+        mapView->onThingUpdate(pos);
+    }
+}
+
 void Map::clean()
 {
     cleanDynamicThings();
@@ -143,7 +153,7 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16 stackPos)
 
     if(thing->isItem() || thing->isCreature() || thing->isEffect()) {
         const TilePtr& tile = getOrCreateTile(pos);
-        if(tile && (m_floatingEffect || !thing->isEffect() || tile->getGround())) {
+        if(tile && (m_floatingEffect || !thing->isEffect() || tile->hasGround())) {
             if(thing->isCreature()) {
                 const auto& creature = thing->static_self_cast<Creature>();
                 for(const MapViewPtr& mapView : m_mapViews)
@@ -157,6 +167,7 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16 stackPos)
 
     if(thing->isMissile()) {
         m_floorMissiles[pos.z].push_back(thing->static_self_cast<Missile>());
+        notificateThingUpdate(pos);
         return;
     }
 
@@ -211,6 +222,22 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16 stackPos)
     thing->onAppear();
 }
 
+void Map::addStaticItem(const StaticItem& item, const Position& pos, int16 stackPos)
+{
+    if(const TilePtr& tile = getOrCreateTile(pos))
+        tile->addStaticItem(item, stackPos);
+}
+
+void Map::addLoadedItem(const ItemPtr& item, const Position& pos, int16 stackPos)
+{
+    // nothing refers to a freshly loaded item yet, so it may be kept by value
+    StaticItem staticItem;
+    if(item && item->toStatic(staticItem))
+        addStaticItem(staticItem, pos, stackPos);
+    else
+        addThing(item, pos, stackPos);
+}
+
 ThingPtr Map::getThing(const Position& pos, int16 stackPos)
 {
     if(TilePtr tile = getTile(pos))
@@ -388,6 +415,24 @@ const TileList Map::getTiles(const int8 floor/* = -1*/)
     return tiles;
 }
 
+std::map<std::string, uint64> Map::getMemoryUsage()
+{
+    uint64 tiles = 0, staticItems = 0, bytes = 0;
+    for(int_fast8_t z = -1; ++z <= MAX_Z;) {
+        for(const auto& pair : m_tileBlocks[z]) {
+            for(const TilePtr& tile : pair.second.getTiles()) {
+                if(!tile) continue;
+
+                ++tiles;
+                staticItems += tile->getStaticItems().size();
+                bytes += tile->getMemoryUsage();
+            }
+        }
+    }
+
+    return { { "tiles", tiles }, { "staticItems", staticItems }, { "bytes", bytes } };
+}
+
 void Map::cleanTile(const Position& pos)
 {
     if(!pos.isMapPosition())
@@ -137,6 +137,7 @@ public:
     void addMapView(const MapViewPtr& mapView);
     void removeMapView(const MapViewPtr& mapView);
     void notificateTileUpdate(const Position& pos);
+    void notificateThingUpdate(const Position& pos);
     void notificateCameraMove(const Point& offset);
     void notificateKeyRelease(const InputEvent& inputEvent);
 
@@ -166,6 +167,8 @@ public:
 
     // thing related
     void addThing(const ThingPtr& thing, const Position& pos, int16 stackPos = -1);
+    void addStaticItem(const StaticItem& item, const Position& pos, int16 stackPos = -1);
+    void addLoadedItem(const ItemPtr& item, const Position& pos, int16 stackPos = -1);
     ThingPtr getThing(const Position& pos, int16 stackPos);
     bool removeThing(const ThingPtr& thing);
     bool removeThingByPos(const Position& pos, int16 stackPos);
@@ -179,6 +182,7 @@ public:
     const TilePtr& getOrCreateTile(const Position& pos);
     const TilePtr& getTile(const Position& pos);
     const TileList getTiles(int8 floor = -1);
+    std::map<std::string, uint64> getMemoryUsage();
     void cleanTile(const Position& pos);
 
     // tile zone related
@@ -272,6 +272,12 @@ void MapView::onTileUpdate(const Position&)
     requestVisibleTilesCacheUpdate();
 }
 
+void MapView::onThingUpdate(const Position& pos)
+{
+    if(isInRange(pos, true))
+        requestRedraw();
+}
+
 void MapView::onPositionChange(const Position& /*newPos*/, const Position& /*oldPos*/) {}
 
 // isVirtualMove is when the mouse is stopped, but the camera moves,
@@ -289,6 +295,9 @@ void MapView::onMouseMove(const Position& mousePos, const bool /*isVirtualMove*/
                 m_lastHighlightTile->select(m_shiftPressed);
         }
     }
+
+    // the highlight and the crosshair follow the mouse
+    m_frameCache.tile->update();
 }
 
 void MapView::onKeyRelease(const InputEvent& inputEvent)
@@ -305,6 +314,12 @@ void MapView::onMapCenterChange(const Position&)
     requestVisibleTilesCacheUpdate();
 }
 
+void MapView::requestRedraw()
+{
+    m_frameCache.tile->update();
+    if(m_drawLights) m_lightView->update();
+}
+
 void MapView::updateLight()
 {
     if(!m_drawLights) return;
@@ -598,9 +613,19 @@ void MapView::setDrawLights(bool enable)
     m_lightView = enable ? LightViewPtr(new LightView(this)) : nullptr;
     m_drawLights = enable;
 
+    if(m_lightView)
+        m_lightView->setGridEnabled(m_lightMode == LIGHT_MODE_GRID);
+
     updateLight();
 }
 
+void MapView::setLightMode(const LightMode mode)
+{
+    m_lightMode = mode;
+    if(m_lightView)
+        m_lightView->setGridEnabled(mode == LIGHT_MODE_GRID);
+}
+
 void MapView::updateViewportDirectionCache()
 {
     for(uint8 dir = Otc::North; dir <= Otc::InvalidDirection; ++dir) {
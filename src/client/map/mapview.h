@@ -56,6 +56,11 @@ public:
         ANTIALIASING_SMOOTH_RETRO
     };
 
+    enum LightMode : uint8 {
+        LIGHT_MODE_TEXTURED,
+        LIGHT_MODE_GRID
+    };
+
     MapView();
     ~MapView() override;
 
@@ -109,6 +114,9 @@ public:
     void setDrawLights(bool enable);
     bool isDrawingLights() { return m_drawLights && m_lightView->isDark(); }
 
+    void setLightMode(LightMode mode);
+    LightMode getLightMode() { return m_lightMode; }
+
     void setDrawViewportEdge(bool enable) { m_drawViewportEdge = enable; }
     bool isDrawingViewportEdge() { return m_drawViewportEdge; }
 
@@ -146,6 +154,7 @@ public:
 protected:
     void onCameraMove(const Point& offset);
     void onTileUpdate(const Position& pos);
+    void onThingUpdate(const Position& pos);
     void onFloorDrawingEnd(uint8 floor);
     void onFloorDrawingStart(uint8 floor);
     void onMapCenterChange(const Position& pos);
@@ -163,6 +172,9 @@ private:
         FrameBufferPtr tile, staticText, dynamicText, creatureInformation;
 
         uint32_t flags = Otc::FUpdateAll;
+
+        // when the first thing drawn on the last frame changes by itself
+        ticks_t nextAnimationTicks{ std::numeric_limits<ticks_t>::max() };
     };
 
     struct RectCache {
@@ -173,6 +185,7 @@ private:
 
     void updateStaticTextFrame() { m_frameCache.staticText->update(); }
     void requestVisibleTilesCacheUpdate() { m_mustUpdateVisibleTilesCache = true; }
+    void requestRedraw();
     void updateGeometry(const Size& visibleDimension, const Size& optimizedSize);
     void updateVisibleTilesCache();
 
@@ -202,6 +215,8 @@ private:
         m_floorMax{ 0 },
         m_antiAliasingMode;
 
+    LightMode m_lightMode{ LIGHT_MODE_TEXTURED };
+
     float m_minimumAmbientLight{ 0 },
         m_fadeInTime{ 0 },
         m_fadeOutTime{ 0 },
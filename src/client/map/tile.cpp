@@ -30,17 +30,27 @@
 #include <client/protocol/protocolgame.h>
 #include <client/map/map.h>
 #include <client/manager/thingtypemanager.h>
+#include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 
+namespace {
+int getStaticStackPriority(ThingType* type)
+{
+    if(type->isGround())
+        return 0;
+
+    return type->isGroundBorder() ? 1 : 2;
+}
+}
+
 Tile::Tile(const Position& position) : m_position(position)
 {
-    m_positionsAround = position.getPositionsAround();
 }
 
 void Tile::onAddVisibleTileList(const MapViewPtr& /*mapView*/)
 {
     m_isBorder = false;
-    for(const auto& position : m_positionsAround) {
+    for(const auto& position : m_position.getPositionsAround()) {
         const TilePtr& tile = g_map.getTile(position);
         if(!tile || (!tile->isFullyOpaque() && tile->isWalkable(true))) {
             m_isBorder = true;
@@ -61,19 +71,30 @@ bool Tile::isCompletelyCovered(int8 firstFloor)
 
 void Tile::addWalkingCreature(const CreaturePtr& creature)
 {
-    m_walkingCreatures.push_back(creature);
+    transients().walkingCreatures.push_back(creature);
     updateFlag(creature, true);
 }
 
 void Tile::removeWalkingCreature(const CreaturePtr& creature)
 {
-    const auto it = std::find(m_walkingCreatures.begin(), m_walkingCreatures.end(), creature);
-    if(it != m_walkingCreatures.end()) {
+    if(!m_transients)
+        return;
+
+    auto& walkingCreatures = m_transients->walkingCreatures;
+    const auto it = std::find(walkingCreatures.begin(), walkingCreatures.end(), creature);
+    if(it != walkingCreatures.end()) {
         updateFlag(creature, false);
-        m_walkingCreatures.erase(it);
+        walkingCreatures.erase(it);
+        releaseTransients();
     }
 }
 
+const std::vector<CreaturePtr>& Tile::getWalkingCreatures()
+{
+    static const std::vector<CreaturePtr> noCreatures;
+    return m_transients ? m_transients->walkingCreatures : noCreatures;
+}
+
 // TODO: Need refactoring
 // Redo Stack Position System
 void Tile::addThing(const ThingPtr& thing, int stackPos)
@@ -83,18 +104,19 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
 
     if(thing->isEffect()) {
         const EffectPtr& effect = thing->static_self_cast<Effect>();
+        auto& effects = transients().effects;
 
         // find the first effect equal and wait for it to finish.
-        for(const EffectPtr& firstEffect : m_effects) {
+        for(const EffectPtr& firstEffect : effects) {
             if(effect->getId() == firstEffect->getId()) {
                 effect->waitFor(firstEffect);
             }
         }
 
         if(effect->isTopEffect())
-            m_effects.insert(m_effects.begin(), effect);
+            effects.insert(effects.begin(), effect);
         else
-            m_effects.push_back(effect);
+            effects.push_back(effect);
 
         updateFlag(thing, true);
 
@@ -103,7 +125,58 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
         return;
     }
 
-    const uint8_t size = m_things.size();
+    stackPos = findStackPos(thing->getStackPriority(), stackPos);
+
+    // static items stay below every real thing
+    if(stackPos < static_cast<int>(m_staticItems.size()))
+        materializeStaticItems();
+
+    m_things.insert(m_things.begin() + (stackPos - m_staticItems.size()), thing);
+
+    updateFlag(thing, true);
+
+    if(isSelected() && getDetachableThing()) {
+        select();
+    }
+
+    if(getStackSize() > MAX_THINGS)
+        removeThing(getThing(MAX_THINGS));
+
+    thing->setPosition(m_position);
+    thing->onAppear();
+
+    g_map.notificateTileUpdate(thing->getPosition());
+}
+
+void Tile::addStaticItem(const StaticItem& item, int stackPos)
+{
+    ThingType* type = item.rawGetThingType();
+    if(Item::isStaticType(type))
+        stackPos = findStackPos(getStaticStackPriority(type), stackPos);
+
+    // anything else, or an item going above a real thing, has to be a real item
+    if(!Item::isStaticType(type) || stackPos > static_cast<int>(m_staticItems.size())) {
+        addThing(Item::createFromStatic(item), stackPos);
+        return;
+    }
+
+    m_staticItems.insert(m_staticItems.begin() + stackPos, item);
+
+    updateFlags(type->getTileFlags(), type->hasLight(), true);
+
+    if(isSelected() && getDetachableThing()) {
+        select();
+    }
+
+    if(getStackSize() > MAX_THINGS)
+        removeThing(getThing(MAX_THINGS));
+
+    g_map.notificateTileUpdate(m_position);
+}
+
+int Tile::findStackPos(int priority, int stackPos)
+{
+    const int size = getStackSize();
 
     // priority                                    854
     // 0 - ground,                        -->      -->
@@ -113,8 +186,6 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
     // 4 - creatures, from top to bottom  <--      -->
     // 5 - items, from top to bottom      <--      <--
     if(stackPos < 0 || stackPos == 255) {
-        const int priority = thing->getStackPriority();
-
         // -1 or 255 => auto detect position
         // -2        => append
 
@@ -127,29 +198,16 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
                 append = !append;
         }
 
+        const int staticCount = m_staticItems.size();
         for(stackPos = 0; stackPos < size; ++stackPos) {
-            const int otherPriority = m_things[stackPos]->getStackPriority();
+            const int otherPriority = stackPos < staticCount ? getStaticStackPriority(m_staticItems[stackPos].rawGetThingType()) : m_things[stackPos - staticCount]->getStackPriority();
             if((append && otherPriority > priority) || (!append && otherPriority >= priority))
                 break;
         }
-    } else if(stackPos > static_cast<int>(size))
+    } else if(stackPos > size)
         stackPos = size;
 
-    m_things.insert(m_things.begin() + stackPos, thing);
-
-    updateFlag(thing, true);
-  
-    if(checkForDetachableThing() && m_highlight.enabled) {
-        select();
-    }
-
-    if(m_things.size() > MAX_THINGS)
-        removeThing(m_things[MAX_THINGS]);
-
-    thing->setPosition(m_position);
-    thing->onAppear();
-
-    g_map.notificateTileUpdate(thing->getPosition());
+    return stackPos;
 }
 
 // TODO: Need refactoring
@@ -158,14 +216,18 @@ bool Tile::removeThing(const ThingPtr thing)
     if(!thing) return false;
 
     if(thing->isEffect()) {
-        const EffectPtr& effect = thing->static_self_cast<Effect>();
-        const auto it = std::find(m_effects.begin(), m_effects.end(), effect);
-        if(it == m_effects.end())
+        if(!m_transients)
+            return false;
+
+        auto& effects = m_transients->effects;
+        const auto it = std::find(effects.begin(), effects.end(), thing);
+        if(it == effects.end())
             return false;
 
         updateFlag(thing, false);
 
-        m_effects.erase(it);
+        effects.erase(it);
+        releaseTransients();
         return true;
     }
 
@@ -177,7 +239,7 @@ bool Tile::removeThing(const ThingPtr thing)
 
     m_things.erase(it);
 
-    if(checkForDetachableThing()) unselect();
+    if(m_highlight && getDetachableThing()) unselect();
 
     thing->onDisappear();
 
@@ -188,12 +250,67 @@ bool Tile::removeThing(const ThingPtr thing)
 
 ThingPtr Tile::getThing(int stackPos)
 {
-    if(stackPos >= 0 && stackPos < static_cast<int>(m_things.size()))
-        return m_things[stackPos];
+    if(stackPos < 0 || stackPos >= getStackSize())
+        return nullptr;
+
+    if(stackPos < static_cast<int>(m_staticItems.size()))
+        materializeStaticItems();
+
+    return m_things[stackPos - m_staticItems.size()];
+}
+
+ThingType* Tile::rawGetThingType(int stackPos)
+{
+    const int staticCount = m_staticItems.size();
+    if(stackPos < staticCount)
+        return m_staticItems[stackPos].rawGetThingType();
+
+    if(stackPos - staticCount < static_cast<int>(m_things.size()))
+        return m_things[stackPos - staticCount]->rawGetThingType();
 
     return nullptr;
 }
 
+const std::vector<ThingPtr>& Tile::getThings()
+{
+    materializeStaticItems();
+    return m_things;
+}
+
+void Tile::materializeStaticItems()
+{
+    if(m_staticItems.empty())
+        return;
+
+    // all of them at once, so the stack stays in order
+    std::vector<ThingPtr> items;
+    items.reserve(m_staticItems.size());
+    for(const StaticItem& staticItem : m_staticItems) {
+        const ItemPtr& item = Item::createFromStatic(staticItem);
+        item->setPosition(m_position);
+        items.push_back(item);
+    }
+
+    m_things.insert(m_things.begin(), items.begin(), items.end());
+    m_staticItems.clear();
+    m_staticItems.shrink_to_fit();
+}
+
+void Tile::clean()
+{
+    m_staticItems.clear();
+    m_things.clear();
+
+    // only effects and walking creatures are left to count
+    m_thingFlags = {};
+    if(m_transients) {
+        for(const EffectPtr& effect : m_transients->effects)
+            updateFlag(effect, true);
+        for(const CreaturePtr& creature : m_transients->walkingCreatures)
+            updateFlag(creature, true);
+    }
+}
+
 const std::vector<CreaturePtr> Tile::getCreatures()
 {
     std::vector<CreaturePtr> creatures;
@@ -210,7 +327,7 @@ const std::vector<CreaturePtr> Tile::getCreatures()
 int8 Tile::getThingStackPos(const ThingPtr& thing)
 {
     for(int stackpos = -1, s = m_things.size(); ++stackpos < s;) {
-        if(thing == m_things[stackpos]) return stackpos;
+        if(thing == m_things[stackpos]) return m_staticItems.size() + stackpos;
     }
 
     return -1;
@@ -225,11 +342,13 @@ ThingPtr Tile::getTopThing()
         if(thing->isCommon())
             return thing;
 
-    return m_things[m_things.size() - 1];
+    return getThing(getStackSize() - 1);
 }
 
 std::vector<ItemPtr> Tile::getItems()
 {
+    materializeStaticItems();
+
     std::vector<ItemPtr> items;
     for(const ThingPtr& thing : m_things) {
         if(!thing->isItem())
@@ -242,18 +361,39 @@ std::vector<ItemPtr> Tile::getItems()
 
 ItemPtr Tile::getGround()
 {
-    const ThingPtr& firstObject = getThing(0);
-    if(!firstObject) return nullptr;
+    if(!rawGetGroundType())
+        return nullptr;
 
-    if(firstObject->isGround() && firstObject->isItem())
-        return firstObject->static_self_cast<Item>();
+    return getThing(0)->static_self_cast<Item>();
+}
 
-    return nullptr;
+ThingType* Tile::rawGetGroundType()
+{
+    if(m_staticItems.empty() && (m_things.empty() || !m_things[0]->isItem()))
+        return nullptr;
+
+    ThingType* type = rawGetThingType(0);
+    return type->isGround() ? type : nullptr;
+}
+
+size_t Tile::getMemoryUsage()
+{
+    // the tile, its stack and the items only it holds, transients come and go
+    size_t bytes = sizeof(Tile) + m_staticItems.capacity() * sizeof(StaticItem) + m_things.capacity() * sizeof(ThingPtr);
+    for(const ThingPtr& thing : m_things) {
+        if(thing->isItem())
+            bytes += sizeof(Item);
+    }
+
+    return bytes;
 }
 
 EffectPtr Tile::getEffect(uint16 id)
 {
-    for(const EffectPtr& effect : m_effects)
+    if(!m_transients)
+        return nullptr;
+
+    for(const EffectPtr& effect : m_transients->effects)
         if(effect->getId() == id)
             return effect;
 
@@ -262,7 +402,7 @@ EffectPtr Tile::getEffect(uint16 id)
 
 uint16 Tile::getGroundSpeed()
 {
-    if(const ItemPtr& ground = getGround())
+    if(ThingType* ground = rawGetGroundType())
         return ground->getGroundSpeed();
 
     return 100;
@@ -282,6 +422,11 @@ uint8 Tile::getMinimapColorByte()
         if(c != 0) return c;
     }
 
+    for(auto it = m_staticItems.rbegin(); it != m_staticItems.rend(); ++it) {
+        const uint8 c = it->rawGetThingType()->getMinimapColor();
+        if(c != 0) return c;
+    }
+
     return 255;
 }
 
@@ -290,6 +435,8 @@ ThingPtr Tile::getTopLookThing()
     if(isEmpty())
         return nullptr;
 
+    materializeStaticItems();
+
     for(auto thing : m_things) {
         if(!thing->isIgnoreLook() && (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop()))
             return thing;
@@ -303,6 +450,8 @@ ThingPtr Tile::getTopUseThing()
     if(isEmpty())
         return nullptr;
 
+    materializeStaticItems();
+
     for(auto thing : m_things) {
         if(thing->isForceUse() || (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop() && !thing->isCreature() && !thing->isSplash()))
             return thing;
@@ -331,12 +480,12 @@ CreaturePtr Tile::getTopCreature(const bool checkAround)
     if(creature)
         return creature;
 
-    if(!m_walkingCreatures.empty())
-        return m_walkingCreatures.back();
+    if(hasWalkingCreatures())
+        return m_transients->walkingCreatures.back();
 
     // check for walking creatures in tiles around
     if(checkAround) {
-        for(const auto& position : m_positionsAround) {
+        for(const auto& position : m_position.getPositionsAround()) {
             const TilePtr& tile = g_map.getTile(position);
             if(!tile) continue;
 
@@ -356,6 +505,8 @@ ThingPtr Tile::getTopMoveThing()
     if(isEmpty())
         return nullptr;
 
+    materializeStaticItems();
+
     for(uint i = 0; i < m_things.size(); ++i) {
         const ThingPtr& thing = m_things[i];
         if(thing->isCommon()) {
@@ -379,6 +530,8 @@ ThingPtr Tile::getTopMultiUseThing()
     if(isEmpty())
         return nullptr;
 
+    materializeStaticItems();
+
     if(const CreaturePtr& topCreature = getTopCreature())
         return topCreature;
 
@@ -407,7 +560,7 @@ ThingPtr Tile::getTopMultiUseThing()
 
 bool Tile::isWalkable(bool ignoreCreatures)
 {
-    if(m_countFlag.notWalkable || !getGround()) {
+    if(hasThingFlag(TileThingNotWalkable) || !rawGetGroundType()) {
         return false;
     }
 
@@ -429,13 +582,14 @@ bool Tile::isClickable()
     bool hasGround = false;
     bool hasOnBottom = false;
     bool hasIgnoreLook = false;
-    for(const ThingPtr& thing : m_things) {
-        if(thing->isGround())
+    for(int stackPos = 0, size = getStackSize(); stackPos < size; ++stackPos) {
+        ThingType* type = rawGetThingType(stackPos);
+        if(type->isGround())
             hasGround = true;
-        else if(thing->isOnBottom())
+        else if(type->isOnBottom())
             hasOnBottom = true;
 
-        if(thing->isIgnoreLook())
+        if(type->isIgnoreLook())
             hasIgnoreLook = true;
 
         if((hasGround || hasOnBottom) && !hasIgnoreLook)
@@ -448,175 +602,163 @@ bool Tile::isClickable()
 bool Tile::limitsFloorsView(bool isFreeView)
 {
     // ground and walls limits the view
-    const ThingPtr& firstThing = getThing(0);
+    ThingType* firstThing = rawGetThingType(0);
     return firstThing && (firstThing->isGround() || (isFreeView ? firstThing->isOnBottom() && firstThing->blockProjectile() : firstThing->isOnBottom()));
 }
 
-bool Tile::checkForDetachableThing()
+ThingPtr Tile::getDetachableThing()
 {
-    if(m_highlight.thing = getTopCreature())
-        return true;
+    if(const CreaturePtr& creature = getTopCreature())
+        return creature;
 
     if(m_highlightWithoutFilter) {
+        materializeStaticItems();
         for(auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
             const auto& item = *it;
             if(!item->canDraw()) continue;
 
-            m_highlight.thing = item;
-            return true;
+            return item;
         }
 
-        return false;
+        return nullptr;
     }
 
-    if(m_countFlag.hasCommonItem) {
+    if(hasThingFlag(TileThingCommon)) {
         for(const auto& item : m_things) {
             if((!item->isCommon() || !item->canDraw() || item->isIgnoreLook() || item->isCloth()) && (!item->isUsable()) && (!item->hasLight())) {
                 continue;
             }
 
-            m_highlight.thing = item;
-            return true;
+            return item;
         }
     }
 
-    if(m_countFlag.hasBottomItem) {
+    if(hasThingFlag(TileThingBottom)) {
+        materializeStaticItems();
         for(auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
             const auto& item = *it;
             if(!item->isOnBottom() || !item->canDraw() || item->isIgnoreLook() || item->isFluidContainer()) continue;
-            m_highlight.thing = item;
-            return true;
+            return item;
         }
     }
 
-    if(m_countFlag.hasTopItem) {
+    if(hasThingFlag(TileThingTop)) {
         for(auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
             const auto& item = *it;
             if(!item->isOnTop()) break;
             if(!item->canDraw() || item->isIgnoreLook()) continue;
 
-            if(item->hasLensHelp()) {
-                m_highlight.thing = item;
-                return true;
-            }
+            if(item->hasLensHelp())
+                return item;
         }
     }
 
-    return false;
+    return nullptr;
 }
 
 void Tile::updateFlag(const ThingPtr& thing, bool add)
 {
-    const int value = add ? 1 : -1;
-
-    if(thing->hasLight())
-        m_countFlag.hasLight += value;
-
-    if(thing->hasDisplacement())
-        m_countFlag.hasDisplacement += value;
-
-    if(thing->isEffect()) return;
-
-    if(thing->isCommon())
-        m_countFlag.hasCommonItem += value;
-
-    if(thing->isOnTop())
-        m_countFlag.hasTopItem += value;
-
-    if(thing->isCreature())
-        m_countFlag.hasCreature += value;
-
-    if(thing->isGroundOrBorder())
-        m_countFlag.hasGroundOrBorder += value;
+    uint32 flags = thing->rawGetThingType()->getTileFlags();
+    if(thing->isEffect())
+        flags &= 1u << TileThingDisplacement;
+    else if(!thing->isItem()) {
+        flags &= (1u << TileThingNotWalkable) - 1;
+        if(thing->isCreature()) {
+            flags &= ~(1u << TileThingCommon);
+            flags |= 1u << TileThingCreature;
+        }
+    }
 
-    // Creatures and items
-    if(thing->isOnBottom()) {
-        m_countFlag.hasBottomItem += value;
+    // creatures may change their light, so it is not taken from the type
+    updateFlags(flags, thing->hasLight(), add);
+}
 
-        if(thing->isHookSouth())
-            m_countFlag.hasHookSouth += value;
+void Tile::updateFlags(uint32 flags, bool hasLight, bool add)
+{
+    const int value = add ? 1 : -1;
 
-        if(thing->isHookEast())
-            m_countFlag.hasHookEast += value;
-    }
+    if(hasLight)
+        m_thingFlags[TileThingLight] += value;
 
-    if(m_position.z == SEA_FLOOR && (thing->isTranslucent() || thing->hasLensHelp())) {
+    if(flags & (1u << TileThingTranslucent)) {
         Position downPos = m_position;
-        if(downPos.down()) {
-            TilePtr tile = g_map.getOrCreateTile(downPos);
-            if(tile) m_countFlag.hasTransluecentLight += value;
-        }
+        if(m_position.z == SEA_FLOOR && downPos.down() && g_map.getOrCreateTile(downPos))
+            flags |= 1u << TileThingTranslucentLight;
     }
 
-    // best option to have something more real, but in some cases as a custom project,
-    // the developers are not defining crop size
-    //if(thing->getRealSize() > SPRITE_SIZE)
-    if(thing->getHeight() != 1 || thing->getWidth() != 1)
-        m_countFlag.notSingleDimension += value;
-
-    if(thing->getHeight() > 1)
-        m_countFlag.hasTallThings += value;
+    for(int flag = 0; flags != 0; ++flag, flags >>= 1) {
+        if(flags & 1)
+            m_thingFlags[flag] += value;
+    }
+}
 
-    if(thing->getWidth() > 1)
-        m_countFlag.hasWideThings += value;
+ticks_t Tile::getNextAnimationTicks()
+{
+    // effects, walking creatures and the highlight fade change on every frame
+    if(hasEffects() || hasWalkingCreatures() || isSelected())
+        return g_clock.millis();
 
-    if(!thing->isItem()) return;
+    ticks_t next = std::numeric_limits<ticks_t>::max();
+    if(!hasThingFlag(TileThingAnimated) && !hasCreature())
+        return next;
 
-    if(thing->isNotWalkable())
-        m_countFlag.notWalkable += value;
+    for(const ThingPtr& thing : m_things) {
+        if(thing->isItem() || thing->isCreature())
+            next = std::min<ticks_t>(next, thing->getNextAnimationTicks());
+    }
 
-    if(thing->isNotPathable())
-        m_countFlag.notPathable += value;
+    for(const StaticItem& item : m_staticItems)
+        next = std::min<ticks_t>(next, Item::getAsyncNextAnimationTicks(item.rawGetThingType()));
 
-    if(thing->blockProjectile())
-        m_countFlag.blockProjectile += value;
+    return next;
+}
 
-    m_countFlag.totalElevation += thing->getElevation() * value;
+void Tile::select(const bool noFilter)
+{
+    if(!m_highlight)
+        m_highlight = std::make_unique<Highlight>();
 
-    if(thing->isFullGround())
-        m_countFlag.fullGround += value;
+    m_highlight->enabled = true;
+    m_highlightWithoutFilter = noFilter;
+    m_highlight->thing = getDetachableThing();
 
-    if(thing->hasElevation())
-        m_countFlag.elevation += value;
+    if(!m_highlight->thing) return;
 
-    if(thing->isOpaque())
-        m_countFlag.opaque += value;
+    if(m_highlight->listeningEvent)
+        m_highlight->listeningEvent->cancel();
 
-    if(thing->isTopGround())
-        m_countFlag.hasTopGround += value;
+    m_highlight->invertedColorSelection = false;
+    m_highlight->fadeLevel = HIGHTLIGHT_FADE_START;
+    m_highlight->listeningEvent = g_dispatcher.cycleEvent([=]() {
+        Highlight& highlight = *m_highlight;
+        highlight.fadeLevel += 10 * (highlight.invertedColorSelection ? 1 : -1);
+        highlight.rgbColor = Color(static_cast<uint8>(255), static_cast<uint8>(255), static_cast<uint8>(0), highlight.fadeLevel);
 
-    if(thing->isGroundBorder() && thing->isNotWalkable())
-        m_countFlag.hasNoWalkableEdge += value;
+        if(highlight.invertedColorSelection ? highlight.fadeLevel > HIGHTLIGHT_FADE_END : highlight.fadeLevel < HIGHTLIGHT_FADE_START) {
+            highlight.invertedColorSelection = !highlight.invertedColorSelection;
+        }
+    }, 40);
 }
 
-void Tile::select(const bool noFilter)
+void Tile::unselect()
 {
-    m_highlight.enabled = true;
-
-    if(noFilter != m_highlightWithoutFilter) {
-        m_highlightWithoutFilter = noFilter;
-        checkForDetachableThing();
-    }
-  
-    if(!m_highlight.thing) return;
+    if(!m_highlight)
+        return;
 
-    m_highlight.invertedColorSelection = false;
-    m_highlight.fadeLevel = HIGHTLIGHT_FADE_START;
-    m_highlight.listeningEvent = g_dispatcher.cycleEvent([=]() {
-        m_highlight.fadeLevel += 10 * (m_highlight.invertedColorSelection ? 1 : -1);
-        m_highlight.rgbColor = Color(static_cast<uint8>(255), static_cast<uint8>(255), static_cast<uint8>(0), m_highlight.fadeLevel);
+    if(m_highlight->listeningEvent)
+        m_highlight->listeningEvent->cancel();
+    m_highlight = nullptr;
+}
 
-        if(m_highlight.invertedColorSelection ? m_highlight.fadeLevel > HIGHTLIGHT_FADE_END : m_highlight.fadeLevel < HIGHTLIGHT_FADE_START) {
-            m_highlight.invertedColorSelection = !m_highlight.invertedColorSelection;
-        }
-    }, 40);
+Tile::Transients& Tile::transients()
+{
+    if(!m_transients)
+        m_transients = std::make_unique<Transients>();
+    return *m_transients;
 }
 
-void Tile::unselect()
+void Tile::releaseTransients()
 {
-    m_highlight.enabled = false;
-    if(m_highlight.listeningEvent) {
-        m_highlight.listeningEvent->cancel();
-        m_highlight.listeningEvent = nullptr;
-    }
+    if(m_transients && m_transients->effects.empty() && m_transients->walkingCreatures.empty())
+        m_transients = nullptr;
 }
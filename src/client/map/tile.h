@@ -67,6 +67,7 @@ public:
     void removeWalkingCreature(const CreaturePtr& creature);
 
     void addThing(const ThingPtr& thing, int stackPos);
+    void addStaticItem(const StaticItem& item, int stackPos);
     bool removeThing(const ThingPtr thing);
 
     EffectPtr getEffect(uint16 id);
@@ -83,19 +84,23 @@ public:
     uint8 getDrawElevation() { return m_drawElevation; }
 
     const Position& getPosition() { return m_position; }
-    const std::vector<ThingPtr>& getThings() { return m_things; }
+    const std::vector<ThingPtr>& getThings();
+    const std::vector<StaticItem>& getStaticItems() { return m_staticItems; }
     const std::vector<CreaturePtr> getCreatures();
-    const std::vector<CreaturePtr>& getWalkingCreatures() { return m_walkingCreatures; }
+    const std::vector<CreaturePtr>& getWalkingCreatures();
 
-    const std::array<Position, 8> getPositionsAround() { return m_positionsAround; }
+    const std::array<Position, 8> getPositionsAround() { return m_position.getPositionsAround(); }
 
     ItemPtr getGround();
-    uint8 getThingCount() { return m_things.size() + m_effects.size(); }
+    ThingType* rawGetGroundType();
+    uint8 getThingCount() { return getStackSize() + (m_transients ? m_transients->effects.size() : 0); }
+    ticks_t getNextAnimationTicks();
     uint16 getGroundSpeed();
     uint8 getMinimapColorByte();
     std::vector<ItemPtr> getItems();
+    size_t getMemoryUsage();
 
-    void clean() { m_things.clear(); }
+    void clean();
     void updateFlag(const ThingPtr& thing, bool add);
     void overwriteMinimapColor(uint8 color) { m_minimapColor = color; }
 
@@ -110,75 +115,68 @@ public:
 
     void select(const bool noFilter = false);
     void unselect();
-    bool isSelected() { return m_highlight.enabled; }
+    bool isSelected() { return m_highlight && m_highlight->enabled; }
+    const Highlight& getHighlight() { return m_highlight ? *m_highlight : HIGHLIGHT_NONE; }
 
-    uint8 getElevation() const { return m_countFlag.elevation; }
+    uint8 getElevation() const { return m_thingFlags[TileThingElevation]; }
 
     bool limitsFloorsView(bool isFreeView = false);
 
-    bool canErase() { return m_walkingCreatures.empty() && m_effects.empty() && isEmpty() && m_flags == 0 && m_minimapColor == 0; }
-    bool mustHookEast() { return m_countFlag.hasHookEast; }
-    bool mustHookSouth() { return m_countFlag.hasHookSouth; }
+    bool canErase() { return !m_transients && isEmpty() && m_flags == 0 && m_minimapColor == 0; }
+    bool mustHookEast() { return hasThingFlag(TileThingHookEast); }
+    bool mustHookSouth() { return hasThingFlag(TileThingHookSouth); }
 
-    bool isEmpty() { return m_things.empty(); }
+    bool isEmpty() { return m_things.empty() && m_staticItems.empty(); }
     bool isBorder() { return m_isBorder; };
     bool isCovered() { return m_covered; };
-    bool blockLight() { return m_countFlag.hasNoWalkableEdge && !hasGround(); };
-    bool isPathable() { return !m_countFlag.notPathable; }
-    bool isDrawable() { return !isEmpty() || !m_walkingCreatures.empty() || !m_effects.empty(); }
+    bool blockLight() { return hasThingFlag(TileThingNotWalkableEdge) && !hasGround(); };
+    bool isPathable() { return !hasThingFlag(TileThingNotPathable); }
+    bool isDrawable() { return !isEmpty() || m_transients; }
     bool isClickable();
-    bool isTopGround() const { return m_countFlag.hasTopGround > 0; }
+    bool isTopGround() const { return hasThingFlag(TileThingTopGround); }
     bool isHouseTile() { return m_houseId != 0 && (m_flags & TILESTATE_HOUSE) == TILESTATE_HOUSE; }
     bool isWalkable(bool ignoreCreatures = false);
-    bool isFullGround() { return m_countFlag.fullGround; }
-    bool isFullyOpaque() { return isFullGround() || m_countFlag.opaque; }
-    bool isLookPossible() { return !m_countFlag.blockProjectile; }
-    bool isSingleDimension() { return !m_countFlag.notSingleDimension && m_walkingCreatures.empty(); }
+    bool isFullGround() { return hasThingFlag(TileThingFullGround); }
+    bool isFullyOpaque() { return isFullGround() || hasThingFlag(TileThingOpaque); }
+    bool isLookPossible() { return !hasThingFlag(TileThingBlockProjectile); }
+    bool isSingleDimension() { return !hasThingFlag(TileThingNotSingleDimension) && !hasWalkingCreatures(); }
     bool isCompletelyCovered(int8 firstFloor = -1);
 
-    bool hasLight() { return m_countFlag.hasLight; }
-    bool hasGround() { return getGround() != nullptr; };
-    bool hasCreature() { return m_countFlag.hasCreature; }
-    bool hasTopToDraw() const { return m_countFlag.hasTopItem || !m_effects.empty(); }
-    bool hasTallThings() { return m_countFlag.hasTallThings; }
-    bool hasWideThings() { return m_countFlag.hasWideThings; }
-    bool hasDisplacement() { return m_countFlag.hasDisplacement; }
-    bool hasGroundToDraw() const { return m_countFlag.hasGroundOrBorder; }
-    bool hasBottomToDraw() const { return m_countFlag.hasBottomItem || m_countFlag.hasCommonItem || m_countFlag.hasCreature || !m_walkingCreatures.empty(); }
-    bool hasTranslucentLight() { return m_countFlag.hasTransluecentLight; }
-    bool hasElevation(int elevation) { return m_countFlag.elevation >= elevation; }
+    bool hasLight() { return hasThingFlag(TileThingLight); }
+    bool hasGround() { return rawGetGroundType() != nullptr; };
+    bool hasCreature() { return hasThingFlag(TileThingCreature); }
+    bool hasTopToDraw() const { return hasThingFlag(TileThingTop) || hasEffects(); }
+    bool hasTallThings() { return hasThingFlag(TileThingTall); }
+    bool hasWideThings() { return hasThingFlag(TileThingWide); }
+    bool hasDisplacement() { return hasThingFlag(TileThingDisplacement); }
+    bool hasGroundToDraw() const { return hasThingFlag(TileThingGroundOrBorder); }
+    bool hasBottomToDraw() const { return hasThingFlag(TileThingBottom) || hasThingFlag(TileThingCommon) || hasThingFlag(TileThingCreature) || hasWalkingCreatures(); }
+    bool hasTranslucentLight() { return hasThingFlag(TileThingTranslucentLight); }
+    bool hasElevation(int elevation) { return m_thingFlags[TileThingElevation] >= elevation; }
     bool hasThing(const ThingPtr& thing) { return std::find(m_things.begin(), m_things.end(), thing) != m_things.end(); }
 
     TilePtr asTile() { return static_self_cast<Tile>(); }
 
 private:
-    struct CountFlag {
-        uint8 fullGround = 0,
-            notWalkable = 0,
-            notPathable = 0,
-            notSingleDimension = 0,
-            blockProjectile = 0,
-            totalElevation = 0,
-            hasDisplacement = 0,
-            isNotPathable = 0,
-            elevation = 0,
-            opaque = 0,
-            hasLight = 0,
-            hasTallThings = 0,
-            hasWideThings = 0,
-            hasHookEast = 0,
-            hasHookSouth = 0,
-            hasTopGround = 0,
-            hasNoWalkableEdge = 0,
-            hasCreature = 0,
-            hasCommonItem = 0,
-            hasTopItem = 0,
-            hasBottomItem = 0,
-            hasGroundOrBorder = 0,
-            hasTransluecentLight = 0;
+    // effects and walking creatures are only on a few tiles at a time
+    struct Transients {
+        std::vector<EffectPtr> effects;
+        std::vector<CreaturePtr> walkingCreatures;
     };
 
-    bool checkForDetachableThing();
+    Transients& transients();
+    void releaseTransients();
+    bool hasEffects() const { return m_transients && !m_transients->effects.empty(); }
+    bool hasWalkingCreatures() const { return m_transients && !m_transients->walkingCreatures.empty(); }
+    bool hasThingFlag(TileThingFlag flag) const { return m_thingFlags[flag] > 0; }
+    void updateFlags(uint32 flags, bool hasLight, bool add);
+
+    int getStackSize() const { return m_staticItems.size() + m_things.size(); }
+    int findStackPos(int priority, int stackPos);
+    ThingType* rawGetThingType(int stackPos);
+    void materializeStaticItems();
+
+    ThingPtr getDetachableThing();
 
     Position m_position;
 
@@ -188,14 +186,15 @@ private:
     uint8 m_drawElevation{ 0 },
         m_minimapColor{ 0 };
 
-    std::array<Position, 8> m_positionsAround;
+    // number of things having each flag
+    std::array<uint8, TileThingLast> m_thingFlags{};
 
+    // the bottom of the stack, grounds, borders and walls without any state of
+    // their own are kept by value and only become Items when asked for
+    std::vector<StaticItem> m_staticItems;
     std::vector<ThingPtr> m_things;
-    std::vector<EffectPtr> m_effects;
-    std::vector<CreaturePtr> m_walkingCreatures;
-
-    CountFlag m_countFlag;
-    Highlight m_highlight;
+    std::unique_ptr<Transients> m_transients;
+    std::unique_ptr<Highlight> m_highlight;
 
     bool m_covered{ false },
         m_completelyCovered{ false },
@@ -30,6 +30,72 @@
 
 #include "framework/stdext/math.h"
 
+namespace {
+    struct BatchKeyHash
+    {
+        size_t operator()(const Color& color) const { return std::hash<uint32>()(color.rgba()); }
+        size_t operator()(const Texture* texture) const { return std::hash<const Texture*>()(texture); }
+        size_t operator()(const std::pair<Texture*, Color>& key) const { return (*this)(key.first) ^ (*this)(key.second) * 31; }
+    };
+
+    // coords buffers grouped by key (color or texture) for a single frame, so
+    // everything sharing a key is drawn with a single call, keys are dropped on
+    // flush and only the buffers are kept for reuse
+    template<typename Key>
+    class CoordsBatch
+    {
+    public:
+        CoordsBuffer& get(const Key& key)
+        {
+            const auto it = m_index.find(key);
+            if(it != m_index.end())
+                return *m_entries[it->second].second;
+
+            std::unique_ptr<CoordsBuffer> buffer;
+            if(m_spare.empty()) {
+                buffer = std::make_unique<CoordsBuffer>();
+            } else {
+                buffer = std::move(m_spare.back());
+                m_spare.pop_back();
+            }
+
+            m_index.emplace(key, m_entries.size());
+            m_entries.emplace_back(key, std::move(buffer));
+            return *m_entries.back().second;
+        }
+
+        template<typename Draw>
+        void flush(const Draw& draw)
+        {
+            for(auto& entry : m_entries) {
+                if(entry.second->getVertexCount() > 0)
+                    draw(entry.first, *entry.second);
+                entry.second->clear();
+                m_spare.push_back(std::move(entry.second));
+            }
+            m_entries.clear();
+            m_index.clear();
+        }
+
+    private:
+        std::vector<std::pair<Key, std::unique_ptr<CoordsBuffer>>> m_entries;
+        std::unordered_map<Key, size_t, BatchKeyHash> m_index;
+        std::vector<std::unique_ptr<CoordsBuffer>> m_spare;
+    };
+
+    CoordsBatch<Color> s_barBackgrounds;
+    CoordsBatch<Color> s_bars;
+    CoordsBatch<std::pair<Texture*, Color>> s_names;
+    CoordsBatch<Texture*> s_icons;
+
+    void addIcon(const TexturePtr& texture, const Point& pos)
+    {
+        if(texture->isEmpty())
+            return;
+        s_icons.get(texture.get()).addRect(Rect(pos, texture->getSize()), Rect(Point(), texture->getSize()));
+    }
+}
+
 void CreaturePainter::draw(const CreaturePtr& creature, const Point& dest, float scaleFactor, const Highlight& highLight, int frameFlags, LightView* lightView)
 {
     if(!creature->canBeSeen())
@@ -239,19 +305,15 @@ void CreaturePainter::drawInformation(const CreaturePtr& creature, const Rect& p
     healthRect.setWidth((creature->m_healthPercent / 100.0) * 25);
 
     if(drawFlags & Otc::DrawBars) {
-        g_painter->setColor(Color::black);
-        g_painter->drawFilledRect(backgroundRect);
-
-        g_painter->setColor(fillColor);
-        g_painter->drawFilledRect(healthRect);
+        s_barBackgrounds.get(Color::black).addRect(backgroundRect);
+        s_bars.get(fillColor).addRect(healthRect);
 
         if(drawFlags & Otc::DrawManaBar && creature->isLocalPlayer()) {
             LocalPlayerPtr player = g_game.getLocalPlayer();
             if(player) {
                 backgroundRect.moveTop(backgroundRect.bottom());
 
-                g_painter->setColor(Color::black);
-                g_painter->drawFilledRect(backgroundRect);
+                s_barBackgrounds.get(Color::black).addRect(backgroundRect);
 
                 Rect manaRect = backgroundRect.expanded(-1);
                 const double maxMana = player->getMaxMana();
@@ -261,40 +323,45 @@ void CreaturePainter::drawInformation(const CreaturePtr& creature, const Rect& p
                     manaRect.setWidth(player->getMana() / (maxMana * 1.0) * 25);
                 }
 
-                g_painter->setColor(Color::blue);
-                g_painter->drawFilledRect(manaRect);
+                s_bars.get(Color::blue).addRect(manaRect);
             }
         }
     }
 
     if(drawFlags & Otc::DrawNames) {
-        g_painter->setColor(fillColor);
-        creature->m_nameCache.draw(textRect);
+        const BitmapFontPtr& font = creature->m_nameCache.getFont();
+        if(font && font->getTexture())
+            creature->m_nameCache.appendCoords(s_names.get({ font->getTexture().get(), fillColor }), textRect);
     }
 
-    if(creature->m_skull != Otc::SkullNone && creature->m_skullTexture) {
-        g_painter->resetColor();
-        const auto skullRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5, creature->m_skullTexture->getSize());
-        g_painter->drawTexturedRect(skullRect, creature->m_skullTexture);
-    }
-    if(creature->m_shield != Otc::ShieldNone && creature->m_shieldTexture && creature->m_showShieldTexture) {
-        g_painter->resetColor();
-        const auto shieldRect = Rect(backgroundRect.x() + 13.5, backgroundRect.y() + 5, creature->m_shieldTexture->getSize());
-        g_painter->drawTexturedRect(shieldRect, creature->m_shieldTexture);
-    }
-    if(creature->m_emblem != Otc::EmblemNone && creature->m_emblemTexture) {
-        g_painter->resetColor();
-        const auto emblemRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 16, creature->m_emblemTexture->getSize());
-        g_painter->drawTexturedRect(emblemRect, creature->m_emblemTexture);
-    }
-    if(creature->m_type != Proto::CREATURE_TYPE_UNKNOW && creature->m_typeTexture) {
-        g_painter->resetColor();
-        const auto typeRect = Rect(backgroundRect.x() + 13.5 + 12 + 12, backgroundRect.y() + 16, creature->m_typeTexture->getSize());
-        g_painter->drawTexturedRect(typeRect, creature->m_typeTexture);
-    }
-    if(creature->m_icon != Otc::NpcIconNone && creature->m_iconTexture) {
-        g_painter->resetColor();
-        const auto iconRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5, creature->m_iconTexture->getSize());
-        g_painter->drawTexturedRect(iconRect, creature->m_iconTexture);
-    }
+    if(creature->m_skull != Otc::SkullNone && creature->m_skullTexture)
+        addIcon(creature->m_skullTexture, Point(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5));
+    if(creature->m_shield != Otc::ShieldNone && creature->m_shieldTexture && creature->m_showShieldTexture)
+        addIcon(creature->m_shieldTexture, Point(backgroundRect.x() + 13.5, backgroundRect.y() + 5));
+    if(creature->m_emblem != Otc::EmblemNone && creature->m_emblemTexture)
+        addIcon(creature->m_emblemTexture, Point(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 16));
+    if(creature->m_type != Proto::CREATURE_TYPE_UNKNOW && creature->m_typeTexture)
+        addIcon(creature->m_typeTexture, Point(backgroundRect.x() + 13.5 + 12 + 12, backgroundRect.y() + 16));
+    if(creature->m_icon != Otc::NpcIconNone && creature->m_iconTexture)
+        addIcon(creature->m_iconTexture, Point(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5));
+}
+
+void CreaturePainter::flushInformation()
+{
+    const auto drawFill = [](const Color& color, CoordsBuffer& coordsBuffer) {
+        g_painter->setColor(color);
+        g_painter->drawFillCoords(coordsBuffer);
+    };
+    s_barBackgrounds.flush(drawFill);
+    s_bars.flush(drawFill);
+
+    s_names.flush([](const std::pair<Texture*, Color>& key, CoordsBuffer& coordsBuffer) {
+        g_painter->setColor(key.second);
+        g_painter->drawTextureCoords(coordsBuffer, TexturePtr(key.first));
+    });
+
+    g_painter->resetColor();
+    s_icons.flush([](Texture* texture, CoordsBuffer& coordsBuffer) {
+        g_painter->drawTextureCoords(coordsBuffer, TexturePtr(texture));
+    });
 }
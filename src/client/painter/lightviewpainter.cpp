@@ -42,31 +42,66 @@ void LightViewPainter::terminate()
     m_lightTexture = nullptr;
 }
 
-void LightViewPainter::drawLights(const LightViewPtr& lightView)
+template<typename ShadeCallback, typename LightCallback>
+void LightViewPainter::visitLights(const LightViewPtr& lightView, const ShadeCallback& onShade, const LightCallback& onLight)
 {
     const auto& mapView = lightView->m_mapView;
     const auto& shadeBase = std::make_pair<Point, Size>(Point(mapView->getTileSize() / 4.8), Size(mapView->getTileSize() * 1.4));
     for(int_fast8_t z = mapView->getFloorMax(); z >= mapView->getFloorMin(); --z) {
         if(z < mapView->getFloorMax()) {
-            g_painter->setColor(lightView->m_globalLightColor);
             for(auto& shade : lightView->m_shades) {
                 if(shade.floor != z) continue;
                 shade.floor = -1;
 
-                g_painter->drawTexturedRect(Rect(shade.pos - shadeBase.first, shadeBase.second), g_lightViewPaint.m_shadeTexture);
+                onShade(Rect(shade.pos - shadeBase.first, shadeBase.second));
             }
         }
 
         auto& lights = lightView->m_lights[z];
         std::sort(lights.begin(), lights.end(), orderLightComparator);
-        for(LightSource& light : lights) {
-            g_painter->setColor(Color::from8bit(light.color, light.brightness));
-            g_painter->drawTexturedRect(Rect(light.pos - Point(light.radius), Size(light.radius * 2)), g_lightViewPaint.m_lightTexture);
-        }
+        for(const LightSource& light : lights)
+            onLight(light);
         lights.clear();
     }
 }
 
+void LightViewPainter::drawLights(const LightViewPtr& lightView)
+{
+    visitLights(lightView, [&](const Rect& rect) {
+        g_painter->setColor(lightView->m_globalLightColor);
+        g_painter->drawTexturedRect(rect, g_lightViewPaint.m_shadeTexture);
+    }, [](const LightSource& light) {
+        g_painter->setColor(Color::from8bit(light.color, light.brightness));
+        g_painter->drawTexturedRect(Rect(light.pos - Point(light.radius), Size(light.radius * 2)), g_lightViewPaint.m_lightTexture);
+    });
+}
+
+void LightViewPainter::drawLightGrid(const LightViewPtr& lightView)
+{
+    LightGrid& grid = *lightView->m_grid;
+    grid.reset(lightView->m_lightbuffer->getSize(), lightView->m_mapView->getTileSize() / static_cast<float>(LightGrid::CELLS_PER_TILE), lightView->m_globalLightColor);
+
+    visitLights(lightView, [&](const Rect& rect) {
+        grid.addShade(rect, lightView->m_globalLightColor);
+    }, [&](const LightSource& light) {
+        grid.addLight(light.pos, light.radius, Color::from8bit(light.color, light.brightness));
+    });
+
+    if(grid.getSize().area() == 0) return;
+
+    // a single small texture replaces all the quads, smoothing does the upscale
+    const ImagePtr& image = grid.toImage();
+    if(!lightView->m_gridTexture) {
+        lightView->m_gridTexture = TexturePtr(new Texture(image));
+        lightView->m_gridTexture->setSmooth(true);
+    } else
+        lightView->m_gridTexture->uploadPixels(image);
+
+    const float cellSize = grid.getCellSize();
+    g_painter->resetColor();
+    g_painter->drawTexturedRect(Rect(0, 0, grid.getSize().width() * cellSize, grid.getSize().height() * cellSize), lightView->m_gridTexture);
+}
+
 void LightViewPainter::draw(const LightViewPtr& lightView, const Rect& dest, const Rect& src)
 {
     // draw light, only if there is darkness
@@ -75,7 +110,10 @@ void LightViewPainter::draw(const LightViewPtr& lightView, const Rect& dest, con
     if(lightView->m_lightbuffer->canUpdate()) {
         lightView->m_lightbuffer->bind(false);
         lightView->m_lightbuffer->clear(lightView->m_globalLightColor);
-        drawLights(lightView);
+        if(lightView->isGridEnabled())
+            drawLightGrid(lightView);
+        else
+            drawLights(lightView);
         lightView->m_lightbuffer->release();
     }
 
@@ -39,7 +39,11 @@ public:
 private:
     static bool orderLightComparator(const LightSource& a, const LightSource& b);
 
+    template<typename ShadeCallback, typename LightCallback>
+    static void visitLights(const LightViewPtr& lightView, const ShadeCallback& onShade, const LightCallback& onLight);
+
     static void drawLights(const LightViewPtr& lightView);
+    static void drawLightGrid(const LightViewPtr& lightView);
 
     void generateLightTexture(), generateShadeTexture();
 
@@ -29,6 +29,7 @@
 #include <client/thing/missile.h>
 #include <client/manager/shadermanager.h>
 
+#include <framework/core/clock.h>
 #include <framework/core/declarations.h>
 #include <framework/graphics/framebuffermanager.h>
 #include <framework/graphics/graphics.h>
@@ -36,12 +37,19 @@
 void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
 {
     // update visible tiles cache when needed
-    if(mapView->m_mustUpdateVisibleTilesCache)
+    if(mapView->m_mustUpdateVisibleTilesCache) {
         mapView->updateVisibleTilesCache();
+        mapView->requestRedraw();
+    }
+
+    // a still scene is only redrawn when something notifies a change, an animated one
+    // when the first thing drawn on it changes its look, at most at the frame buffer rate
+    const bool animated = g_clock.millis() >= mapView->m_frameCache.nextAnimationTicks;
+    const auto& tileFrame = mapView->m_frameCache.tile;
+    const auto redrawThing = tileFrame->hasPendingUpdate() || (animated && tileFrame->canUpdate());
+    const auto redrawLight = mapView->m_drawLights && (mapView->m_lightView->hasPendingUpdate() || (animated && mapView->m_lightView->canUpdate()));
 
     const Position cameraPosition = mapView->getCameraPosition();
-    const auto redrawThing = mapView->m_frameCache.tile->canUpdate();
-    const auto redrawLight = mapView->m_drawLights && mapView->m_lightView->canUpdate();
 
     if(mapView->m_rectCache.rect != rect) {
         mapView->m_rectCache.rect = rect;
@@ -60,16 +68,17 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
         }
 
         const auto& lightView = redrawLight ? mapView->m_lightView.get() : nullptr;
+        ticks_t nextAnimationTicks = std::numeric_limits<ticks_t>::max();
         for(int_fast8_t z = mapView->m_floorMax; z >= mapView->m_floorMin; --z) {
             if(lightView) {
                 const int8 nextFloor = z - 1;
                 if(nextFloor >= mapView->m_floorMin) {
                     lightView->setFloor(nextFloor);
                     for(const auto& tile : mapView->m_cachedVisibleTiles[nextFloor]) {
-                        const auto& ground = tile->getGround();
+                        ThingType* ground = tile->rawGetGroundType();
                         if(ground && !ground->isTranslucent()) {
                             auto pos2D = mapView->transformPositionTo2D(tile->getPosition(), cameraPosition);
-                            if(ground->isTopGround()) {
+                            if(ground->getTileFlags() & (1u << TileThingTopGround)) {
                                 const auto currentPos = tile->getPosition();
                                 for(const auto& pos : currentPos.translatedToDirections({ Otc::South, Otc::East })) {
                                     const auto& nextDownTile = g_map.getTile(pos);
@@ -99,10 +108,15 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
                 TilePainter::drawStart(tile, mapView);
                 TilePainter::draw(tile, mapView->transformPositionTo2D(tile->getPosition(), cameraPosition), mapView->m_scaleFactor, mapView->m_frameCache.flags, lightView);
                 TilePainter::drawEnd(tile, mapView);
+
+                // read after drawing, which advances the animation phases
+                if(redrawThing)
+                    nextAnimationTicks = std::min<ticks_t>(nextAnimationTicks, tile->getNextAnimationTicks());
             }
 
             for(const MissilePtr& missile : g_map.getFloorMissiles(z)) {
                 ThingPainter::draw(missile, mapView->transformPositionTo2D(missile->getPosition(), cameraPosition), mapView->m_scaleFactor, mapView->m_frameCache.flags, lightView);
+                nextAnimationTicks = std::min<ticks_t>(nextAnimationTicks, missile->getNextAnimationTicks());
             }
 
             mapView->onFloorDrawingEnd(z);
@@ -114,6 +128,7 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
                 if(mapView->m_crosshairEffect && mapView->m_crosshairEffect->getId() > 0) {
                     ThingPainter::draw(mapView->m_crosshairEffect, point, mapView->m_scaleFactor, Otc::FUpdateThing, nullptr);
                     g_painter->setOpacity(.65);
+                    nextAnimationTicks = std::min<ticks_t>(nextAnimationTicks, mapView->m_crosshairEffect->getNextAnimationTicks());
                 }
 
                 const auto crosshairRect = Rect(point, mapView->m_tileSize, mapView->m_tileSize);
@@ -122,6 +137,7 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
             }
 
             mapView->m_frameCache.tile->release();
+            mapView->m_frameCache.nextAnimationTicks = nextAnimationTicks;
         }
     }
 
@@ -187,6 +203,7 @@ void MapViewPainter::drawCreatureInformation(const MapViewPtr& mapView)
         for(const auto& creature : mapView->m_visibleCreatures) {
             CreaturePainter::drawInformation(creature, mapView->m_rectCache.rect, mapView->transformPositionTo2D(creature->getPosition(), cameraPosition), mapView->m_scaleFactor, mapView->m_rectCache.drawOffset, mapView->m_rectCache.horizontalStretchFactor, mapView->m_rectCache.verticalStretchFactor, flags);
         }
+        CreaturePainter::flushInformation();
         mapView->m_frameCache.creatureInformation->release();
     }
     mapView->m_frameCache.creatureInformation->draw();
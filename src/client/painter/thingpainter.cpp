@@ -89,15 +89,16 @@ void ThingPainter::draw(const ItemPtr& item, const Point& dest, float scaleFacto
     int xPattern = 0, yPattern = 0, zPattern = 0;
     item->calculatePatterns(xPattern, yPattern, zPattern);
 
-    if(item->m_color != Color::alpha)
-        g_painter->setColor(item->m_color);
+    const Color color = item->getColor();
+    if(color != Color::alpha)
+        g_painter->setColor(color);
 
     draw(item->rawGetThingType(), dest, scaleFactor, 0, xPattern, yPattern, zPattern, animationPhase, false, frameFlag, lightView);
 
     /// Sanity check
     /// This is just to ensure that we don't overwrite some color and
     /// screw up the whole rendering.
-    if(item->m_color != Color::alpha)
+    if(color != Color::alpha)
         g_painter->resetColor();
 
     if(highLight.enabled && item == highLight.thing) {
@@ -107,6 +108,20 @@ void ThingPainter::draw(const ItemPtr& item, const Point& dest, float scaleFacto
     }
 }
 
+void ThingPainter::draw(const StaticItem& item, const Position& position, const Point& dest, float scaleFactor, int frameFlag, LightView* lightView)
+{
+    if(item.clientId == 0)
+        return;
+
+    ThingType* type = item.rawGetThingType();
+    const int animationPhase = Item::calculateAsyncAnimationPhase(type);
+
+    int xPattern = 0, yPattern = 0, zPattern = 0;
+    Item::calculatePositionPatterns(type, position, xPattern, yPattern, zPattern);
+
+    draw(type, dest, scaleFactor, 0, xPattern, yPattern, zPattern, animationPhase, false, frameFlag, lightView);
+}
+
 void ThingPainter::draw(const MissilePtr& missile, const Point& dest, float scaleFactor, int frameFlag, LightView* lightView)
 {
     if(missile->m_id == 0)
@@ -54,9 +54,9 @@ void TilePainter::drawThing(const TilePtr& tile, const ThingPtr& thing, const Po
         ThingPainter::draw(thing->static_self_cast<Effect>(), dest, scaleFactor, frameFlag, lightView);
     } else {
         if(thing->isCreature()) {
-            CreaturePainter::draw(thing->static_self_cast<Creature>(), dest, scaleFactor, tile->m_highlight, frameFlag, lightView);
+            CreaturePainter::draw(thing->static_self_cast<Creature>(), dest, scaleFactor, tile->getHighlight(), frameFlag, lightView);
         } else if(thing->isItem()) {
-            ThingPainter::draw(thing->static_self_cast<Item>(), dest, scaleFactor, tile->m_highlight, frameFlag, lightView);
+            ThingPainter::draw(thing->static_self_cast<Item>(), dest, scaleFactor, tile->getHighlight(), frameFlag, lightView);
         }
 
         tile->m_drawElevation += thing->getElevation();
@@ -65,10 +65,32 @@ void TilePainter::drawThing(const TilePtr& tile, const ThingPtr& thing, const Po
     }
 }
 
+void TilePainter::drawStaticItem(const TilePtr& tile, const StaticItem& item, const Point& dest, float scaleFactor, int frameFlag, LightView* lightView)
+{
+    if(tile->m_completelyCovered) {
+        frameFlag = 0;
+
+        if(lightView && tile->hasLight())
+            frameFlag = Otc::FUpdateLight;
+    }
+
+    ThingPainter::draw(item, tile->m_position, dest, scaleFactor, frameFlag, lightView);
+
+    tile->m_drawElevation += item.rawGetThingType()->getElevation();
+    if(tile->m_drawElevation > MAX_ELEVATION)
+        tile->m_drawElevation = MAX_ELEVATION;
+}
+
 void TilePainter::drawGround(const TilePtr& tile, const Point& dest, float scaleFactor, int frameFlags, LightView* lightView)
 {
     if(!tile->hasGroundToDraw()) return;
 
+    for(const auto& item : tile->m_staticItems) {
+        ThingType* type = item.rawGetThingType();
+        if(!type->isGround() && !type->isGroundBorder()) return;
+        drawStaticItem(tile, item, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
+    }
+
     for(const auto& ground : tile->m_things) {
         if(!ground->isGroundOrBorder()) break;
         drawThing(tile, ground, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
@@ -85,7 +107,7 @@ void TilePainter::drawCreature(const TilePtr& tile, const Point& dest, float sca
         }
     }
 
-    for(const auto& creature : tile->m_walkingCreatures) {
+    for(const auto& creature : tile->getWalkingCreatures()) {
         drawThing(tile, creature, Point(
             dest.x + ((creature->getPosition().x - tile->m_position.x) * SPRITE_SIZE - tile->m_drawElevation) * scaleFactor,
             dest.y + ((creature->getPosition().y - tile->m_position.y) * SPRITE_SIZE - tile->m_drawElevation) * scaleFactor
@@ -95,7 +117,12 @@ void TilePainter::drawCreature(const TilePtr& tile, const Point& dest, float sca
 
 void TilePainter::drawBottom(const TilePtr& tile, const Point& dest, float scaleFactor, int frameFlags, LightView* lightView)
 {
-    if(tile->m_countFlag.hasBottomItem) {
+    if(tile->hasThingFlag(TileThingBottom)) {
+        for(const auto& item : tile->m_staticItems) {
+            if(!item.rawGetThingType()->isOnBottom()) continue;
+            drawStaticItem(tile, item, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
+        }
+
         for(const auto& item : tile->m_things) {
             if(!item->isOnBottom()) continue;
             drawThing(tile, item, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
@@ -105,7 +132,7 @@ void TilePainter::drawBottom(const TilePtr& tile, const Point& dest, float scale
     uint8 redrawPreviousTopW = 0,
         redrawPreviousTopH = 0;
 
-    if(tile->m_countFlag.hasCommonItem) {
+    if(tile->hasThingFlag(TileThingCommon)) {
         for(auto it = tile->m_things.rbegin(); it != tile->m_things.rend(); ++it) {
             const auto& item = *it;
             if(!item->isCommon()) continue;
@@ -143,11 +170,13 @@ void TilePainter::drawBottom(const TilePtr& tile, const Point& dest, float scale
 
 void TilePainter::drawTop(const TilePtr& tile, const Point& dest, float scaleFactor, int frameFlags, LightView* lightView)
 {
-    for(const auto& effect : tile->m_effects) {
-        drawThing(tile, effect, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
+    if(tile->hasEffects()) {
+        for(const auto& effect : tile->m_transients->effects) {
+            drawThing(tile, effect, dest - tile->m_drawElevation * scaleFactor, scaleFactor, frameFlags, lightView);
+        }
     }
 
-    if(tile->m_countFlag.hasTopItem) {
+    if(tile->hasThingFlag(TileThingTop)) {
         for(const auto& item : tile->m_things) {
             if(!item->isOnTop()) continue;
             drawThing(tile, item, dest, scaleFactor, frameFlags, lightView);
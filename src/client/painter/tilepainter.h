@@ -37,6 +37,7 @@ public:
     static void drawBottom(const TilePtr& tile, const Point& dest, float scaleFactor, int frameFlags, LightView* lightView = nullptr);
     static void drawTop(const TilePtr& tile, const Point& dest, float scaleFactor, int frameFlags, LightView* lightView = nullptr);
     static void drawThing(const TilePtr& tile, const ThingPtr& thing, const Point& dest, float scaleFactor, int frameFlag, LightView* lightView);
+    static void drawStaticItem(const TilePtr& tile, const StaticItem& item, const Point& dest, float scaleFactor, int frameFlag, LightView* lightView);
 };
 
 #endif
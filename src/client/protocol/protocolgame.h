@@ -282,6 +282,7 @@ public:
 
     Outfit getOutfit(const InputMessagePtr& msg, bool addMount = true, const bool forceMountData = false);
     ThingPtr getThing(const InputMessagePtr& msg);
+    bool getStaticItem(const InputMessagePtr& msg, StaticItem& item);
     ThingPtr getMappedThing(const InputMessagePtr& msg);
     CreaturePtr getCreature(const InputMessagePtr& msg, uint16 type = 0);
     StaticTextPtr getStaticText(const InputMessagePtr& msg, uint16 type = 0);
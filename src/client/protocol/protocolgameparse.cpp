@@ -33,6 +33,11 @@
 #include <client/lua/luavaluecasts.h>
 #include <framework/core/eventdispatcher.h>
 
+namespace {
+// Todo: Temporary correction, the client dat does not contain information saying if the item is podium
+bool isPodium(uint16 id) { return id == 35973 || id == 35974; }
+}
+
 void ProtocolGame::parseMessage(const InputMessagePtr& msg)
 {
     int16 opcode = -1;
@@ -2140,6 +2145,12 @@ int ProtocolGame::setTileDescription(const InputMessagePtr& msg, const Position&
         if(stackPos > 10)
             g_logger.traceError(stdext::format("too many things, pos=%s, stackpos=%d", stdext::to_string(position), stackPos));
 
+        StaticItem item;
+        if(getStaticItem(msg, item)) {
+            g_map.addStaticItem(item, position, stackPos);
+            continue;
+        }
+
         const auto& thing = getThing(msg);
         g_map.addThing(thing, position, stackPos);
     }
@@ -2221,6 +2232,23 @@ ThingPtr ProtocolGame::getThing(const InputMessagePtr& msg)
     return thing;
 }
 
+bool ProtocolGame::getStaticItem(const InputMessagePtr& msg, StaticItem& item)
+{
+    // grounds, borders and walls have no bytes past their id
+    const uint16 id = msg->peekU16();
+    if(id == Proto::UnknownCreature || id == Proto::OutdatedCreature || id == Proto::Creature || id == Proto::StaticText)
+        return false;
+
+    if(!g_things.isValidDatId(id, ThingCategoryItem) || isPodium(id) || !Item::isStaticType(g_things.rawGetThingType(id, ThingCategoryItem)))
+        return false;
+
+    msg->getU16();
+    item.clientId = id;
+    item.serverId = g_things.findItemTypeByClientId(id)->getServerId();
+    item.countOrSubType = 1;
+    return true;
+}
+
 ThingPtr ProtocolGame::getMappedThing(const InputMessagePtr& msg)
 {
     const uint16 x = msg->getU16();
@@ -2412,8 +2440,7 @@ ItemPtr ProtocolGame::getItem(const InputMessagePtr& msg, uint16 id)
     }
 
     // Impl Podium
-    // Todo: Temporary correction, the client dat does not contain information saying if the item is podium
-    if(id == 35973 || id == 35974) {
+    if(isPodium(id)) {
         const uint16 lookType = msg->getU16();
         if(lookType != 0) {
             msg->getU8(); // lookHead
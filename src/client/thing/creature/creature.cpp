@@ -136,6 +136,7 @@ void Creature::jump(int height, int duration)
     m_jumpDuration = duration;
 
     updateJump();
+    g_map.notificateThingUpdate(m_position);
 }
 
 void Creature::updateJump()
@@ -424,7 +425,11 @@ void Creature::setHealthPercent(uint8 healthPercent)
 void Creature::setDirection(Otc::Direction_t direction)
 {
     assert(direction != Otc::InvalidDirection);
+    if(m_direction == direction)
+        return;
+
     m_direction = direction;
+    g_map.notificateThingUpdate(m_position);
 }
 
 void Creature::setOutfit(const Outfit& outfit)
@@ -444,6 +449,7 @@ void Creature::setOutfit(const Outfit& outfit)
     }
 
     m_walkAnimationPhase = 0; // might happen when player is walking and outfit is changed.
+    g_map.notificateThingUpdate(m_position);
 
     callLuaField("onOutfitChange", m_outfit, oldOutfit);
 
@@ -467,6 +473,7 @@ void Creature::setOutfitColor(const Color& color, int duration)
 
     if(duration <= 0) {
         m_outfitColor = color;
+        g_map.notificateThingUpdate(m_position);
         return;
     }
 
@@ -479,6 +486,7 @@ void Creature::updateOutfitColor(Color color, Color finalColor, Color delta, int
 {
     if(m_outfitColorTimer.ticksElapsed() >= duration) {
         m_outfitColor = finalColor;
+        m_outfitColorUpdateEvent = nullptr;
         return;
     }
 
@@ -552,12 +560,12 @@ void Creature::setIcon(uint8 icon)
 
 void Creature::setSkullTexture(const std::string& filename)
 {
-    m_skullTexture = g_textures.getTexture(filename);
+    m_skullTexture = g_textures.getTexture(filename, true);
 }
 
 void Creature::setShieldTexture(const std::string& filename, bool blink)
 {
-    m_shieldTexture = g_textures.getTexture(filename);
+    m_shieldTexture = g_textures.getTexture(filename, true);
     m_showShieldTexture = true;
 
     if(blink && !m_shieldBlink) {
@@ -585,17 +593,17 @@ void Creature::updateShield()
 
 void Creature::setEmblemTexture(const std::string& filename)
 {
-    m_emblemTexture = g_textures.getTexture(filename);
+    m_emblemTexture = g_textures.getTexture(filename, true);
 }
 
 void Creature::setTypeTexture(const std::string& filename)
 {
-    m_typeTexture = g_textures.getTexture(filename);
+    m_typeTexture = g_textures.getTexture(filename, true);
 }
 
 void Creature::setIconTexture(const std::string& filename)
 {
-    m_iconTexture = g_textures.getTexture(filename);
+    m_iconTexture = g_textures.getTexture(filename, true);
 }
 
 void Creature::addTimedSquare(uint8 color)
@@ -608,6 +616,27 @@ void Creature::addTimedSquare(uint8 color)
     g_dispatcher.scheduleEvent([self]() {
         self->removeTimedSquare();
     }, VOLATILE_SQUARE_DURATION);
+
+    g_map.notificateThingUpdate(m_position);
+}
+
+void Creature::removeTimedSquare()
+{
+    m_showTimedSquare = false;
+    g_map.notificateThingUpdate(m_position);
+}
+
+void Creature::showStaticSquare(const Color& color)
+{
+    m_showStaticSquare = true;
+    m_staticSquareColor = color;
+    g_map.notificateThingUpdate(m_position);
+}
+
+void Creature::hideStaticSquare()
+{
+    m_showStaticSquare = false;
+    g_map.notificateThingUpdate(m_position);
 }
 
 Point Creature::getDrawOffset()
@@ -698,6 +727,12 @@ int Creature::getDisplacementY()
     return Thing::getDisplacementY();
 }
 
+void Creature::setLight(const Light& light)
+{
+    m_light = light;
+    g_map.notificateThingUpdate(m_position);
+}
+
 Light Creature::getLight()
 {
     Light light = Thing::getLight();
@@ -733,6 +768,36 @@ int Creature::getCurrentAnimationPhase(const bool mount)
     return m_walkAnimationPhase;
 }
 
+ticks_t Creature::getNextAnimationTicks()
+{
+    const ticks_t ticks = g_clock.millis();
+
+    // moving on its own, everything else notifies its changes
+    if(m_walking || m_walkAnimationPhase != 0 || !m_jumpOffset.isNull() || m_outfitColorUpdateEvent)
+        return ticks;
+
+    // same timings as CreaturePainter::internalDrawOutfit and getCurrentAnimationPhase
+    const auto nextFrame = [ticks](int ticksPerFrame) { return ticks - ticks % ticksPerFrame + ticksPerFrame; };
+
+    if(m_outfit.getCategory() != ThingCategoryCreature) {
+        if(g_things.rawGetThingType(m_outfit.getAuxId(), m_outfit.getCategory())->getAnimationPhases() <= 1)
+            return Thing::getNextAnimationTicks();
+        return nextFrame(m_outfit.getCategory() == ThingCategoryEffect ? INVISIBLE_TICKS_PER_FRAME : ITEM_TICKS_PER_FRAME);
+    }
+
+    ticks_t next = Thing::getNextAnimationTicks();
+    for(ThingType* type : { rawGetThingType(), m_outfit.hasMount() ? rawGetMountThingType() : nullptr }) {
+        if(!type) continue;
+
+        if(const AnimatorPtr& idleAnimator = type->getIdleAnimator())
+            next = std::min<ticks_t>(next, idleAnimator->getNextPhaseTicks());
+        else if(type->isAnimateAlways())
+            next = std::min<ticks_t>(next, nextFrame(std::max<int>(1, std::round(1000 / std::max<int>(1, type->getAnimationPhases())))));
+    }
+
+    return next;
+}
+
 int Creature::getExactSize(int layer, int xPattern, int yPattern, int zPattern, int animationPhase)
 {
     const int numPatternY = getNumPatternY(),
@@ -54,7 +54,7 @@ public:
     void setDirection(Otc::Direction_t direction);
     void setOutfit(const Outfit& outfit);
     void setOutfitColor(const Color& color, int duration);
-    void setLight(const Light& light) { m_light = light; }
+    void setLight(const Light& light);
     void setSpeed(uint16 speed);
     void setBaseSpeed(double baseSpeed);
     void setSkull(uint8 skull);
@@ -70,9 +70,9 @@ public:
     void setPassable(bool passable) { m_passable = passable; }
 
     void addTimedSquare(uint8 color);
-    void removeTimedSquare() { m_showTimedSquare = false; }
-    void showStaticSquare(const Color& color) { m_showStaticSquare = true; m_staticSquareColor = color; }
-    void hideStaticSquare() { m_showStaticSquare = false; }
+    void removeTimedSquare();
+    void showStaticSquare(const Color& color);
+    void hideStaticSquare();
 
     uint32 getId() override { return m_id; }
     std::string getName() { return m_name; }
@@ -105,6 +105,7 @@ public:
 
     int getTotalAnimationPhase();
     int getCurrentAnimationPhase(bool mount = false);
+    ticks_t getNextAnimationTicks() override;
 
     uint32 getTotalWalkedPixels() { return m_totalWalkedPixels; }
 
@@ -25,6 +25,14 @@
 #include <client/game.h>
 #include <client/map/map.h>
 
+#include <framework/core/clock.h>
+
+ticks_t Effect::getNextAnimationTicks()
+{
+    // effects are short lived and mostly change on every phase, no point in guessing
+    return g_clock.millis();
+}
+
 void Effect::onAppear()
 {
     m_animationTimer.restart();
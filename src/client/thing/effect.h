@@ -43,6 +43,8 @@ public:
     const ThingTypePtr& getThingType() override;
     ThingType* rawGetThingType() override;
 
+    ticks_t getNextAnimationTicks() override;
+
     void waitFor(const EffectPtr& firstEffect);
     void setAutoRestart(const bool autoRestart) { m_autoRestart = autoRestart; }
 
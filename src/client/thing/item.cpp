@@ -37,6 +37,15 @@
 #include <framework/core/filestream.h>
 #include <framework/graphics/graphics.h>
 
+// grounds, borders and walls are kept by value on tiles, so a few bytes here add up
+static_assert(sizeof(void*) != 8 || sizeof(Item) == 53, "Item is packed, keep it at 53 bytes on 64 bit builds");
+static_assert(sizeof(StaticItem) == 6, "StaticItem should stay as small as its fields");
+
+ThingType* StaticItem::rawGetThingType() const
+{
+    return g_things.rawGetThingType(clientId, ThingCategoryItem);
+}
+
 ItemPtr Item::create(int id)
 {
     ItemPtr item(new Item);
@@ -52,6 +61,22 @@ ItemPtr Item::createFromOtb(int id)
     return item;
 }
 
+ItemPtr Item::createFromStatic(const StaticItem& staticItem)
+{
+    ItemPtr item(new Item);
+    item->m_clientId = staticItem.clientId;
+    item->m_serverId = staticItem.serverId;
+    item->m_countOrSubType = staticItem.countOrSubType;
+    return item;
+}
+
+bool Item::isStaticType(ThingType* type)
+{
+    return !type->isNull() && (type->isGround() || type->isGroundBorder() || type->isOnBottom())
+        && !type->isStackable() && !type->isSplash() && !type->isFluidContainer() && !type->isHangable()
+        && !type->isChargeable() && !type->isContainer();
+}
+
 std::string Item::getName()
 {
     return g_things.findItemTypeByClientId(m_clientId)->getName();
@@ -103,12 +128,12 @@ void Item::unserializeItem(const BinaryTreePtr& in)
             case ATTR_SCRIPTPROTECTED:
             case ATTR_DUALWIELD:
             case ATTR_DECAYING_STATE:
-                m_attribs.set(attrib, in->getU8());
+                setAttr(static_cast<ItemAttr>(attrib), in->getU8());
                 break;
             case ATTR_ACTION_ID:
             case ATTR_UNIQUE_ID:
             case ATTR_DEPOT_ID:
-                m_attribs.set(attrib, in->getU16());
+                setAttr(static_cast<ItemAttr>(attrib), in->getU16());
                 break;
             case ATTR_CONTAINER_ITEMS:
             case ATTR_ATTACK:
@@ -123,7 +148,7 @@ void Item::unserializeItem(const BinaryTreePtr& in)
             case ATTR_SLEEPERGUID:
             case ATTR_SLEEPSTART:
             case ATTR_ATTRIBUTE_MAP:
-                m_attribs.set(attrib, in->getU32());
+                setAttr(static_cast<ItemAttr>(attrib), in->getU32());
                 break;
             case ATTR_TELE_DEST:
             {
@@ -131,7 +156,7 @@ void Item::unserializeItem(const BinaryTreePtr& in)
                 pos.x = in->getU16();
                 pos.y = in->getU16();
                 pos.z = in->getU8();
-                m_attribs.set(attrib, pos);
+                setAttr(static_cast<ItemAttr>(attrib), pos);
                 break;
             }
             case ATTR_NAME:
@@ -139,7 +164,7 @@ void Item::unserializeItem(const BinaryTreePtr& in)
             case ATTR_DESC:
             case ATTR_ARTICLE:
             case ATTR_WRITTENBY:
-                m_attribs.set(attrib, in->getString());
+                setAttr(static_cast<ItemAttr>(attrib), in->getString());
                 break;
             default:
                 stdext::throw_exception(stdext::format("invalid item attribute %d", attrib));
@@ -161,7 +186,7 @@ void Item::serializeItem(const OutputBinaryTreePtr& out)
     out->addU8(ATTR_CHARGES);
     out->addU16(getCountOrSubType());
 
-    const Position dest = m_attribs.get<Position>(ATTR_TELE_DEST);
+    const Position dest = getAttr<Position>(ATTR_TELE_DEST);
     if(dest.isValid()) {
         out->addU8(ATTR_TELE_DEST);
         out->addPos(dest.x, dest.y, dest.z);
@@ -177,8 +202,8 @@ void Item::serializeItem(const OutputBinaryTreePtr& out)
         out->addU8(getDoorId());
     }
 
-    const uint16 aid = m_attribs.get<uint16>(ATTR_ACTION_ID);
-    const uint16 uid = m_attribs.get<uint16>(ATTR_UNIQUE_ID);
+    const uint16 aid = getAttr<uint16>(ATTR_ACTION_ID);
+    const uint16 uid = getAttr<uint16>(ATTR_UNIQUE_ID);
     if(aid) {
         out->addU8(ATTR_ACTION_ID);
         out->addU16(aid);
@@ -201,7 +226,7 @@ void Item::serializeItem(const OutputBinaryTreePtr& out)
     }
 
     out->endNode();
-    for(const auto& i : m_containerItems)
+    for(const auto& i : getContainerItems())
         i->serializeItem(out);
 }
 
@@ -223,10 +248,63 @@ int Item::getCount()
 ItemPtr Item::clone()
 {
     auto item = ItemPtr(new Item);
-    *(item.get()) = *this;
+    static_cast<Thing&>(*item) = *this;
+    item->m_clientId = m_clientId;
+    item->m_serverId = m_serverId;
+    item->m_countOrSubType = m_countOrSubType;
+    item->m_async = m_async;
+    if(m_extra)
+        item->m_extra = std::make_unique<Extra>(*m_extra);
     return item;
 }
 
+bool Item::toStatic(StaticItem& item)
+{
+    if(m_clientId == 0 || m_extra || !m_async || !canDraw() || !isStaticType(rawGetThingType()))
+        return false;
+
+    item.clientId = m_clientId;
+    item.serverId = m_serverId;
+    item.countOrSubType = m_countOrSubType;
+    return true;
+}
+
+void Item::setColor(const Color& c)
+{
+    // the default color is not worth allocating the extra state for
+    if(c != Color::alpha || m_extra)
+        extra().color = c;
+
+    g_map.notificateThingUpdate(m_position);
+}
+
+ItemPtr Item::getContainerItem(int slot)
+{
+    if(!m_extra || slot < 0 || slot >= static_cast<int>(m_extra->containerItems.size()))
+        return nullptr;
+    return m_extra->containerItems[slot];
+}
+
+void Item::addContainerItemIndexed(const ItemPtr& i, int slot)
+{
+    ItemVector& containerItems = extra().containerItems;
+    if(slot >= 0 && slot < static_cast<int>(containerItems.size()))
+        containerItems[slot] = i;
+}
+
+void Item::removeContainerItem(int slot)
+{
+    if(m_extra && slot >= 0 && slot < static_cast<int>(m_extra->containerItems.size()))
+        m_extra->containerItems[slot] = nullptr;
+}
+
+Item::Extra& Item::extra()
+{
+    if(!m_extra)
+        m_extra = std::make_unique<Extra>();
+    return *m_extra;
+}
+
 void Item::calculatePatterns(int& xPattern, int& yPattern, int& zPattern)
 {
     // Avoid crashes with invalid items
@@ -325,29 +403,59 @@ void Item::calculatePatterns(int& xPattern, int& yPattern, int& zPattern)
 
         xPattern = (color % 4) % getNumPatternX();
         yPattern = (color / 4) % getNumPatternY();
-    } else {
-        xPattern = m_position.x % std::max<int>(getNumPatternX(), 1);
-        yPattern = m_position.y % std::max<int>(getNumPatternY(), 1);
-        zPattern = m_position.z % std::max<int>(getNumPatternZ(), 1);
-    }
+    } else
+        calculatePositionPatterns(rawGetThingType(), m_position, xPattern, yPattern, zPattern);
 }
 
-int Item::calculateAnimationPhase()
+void Item::calculatePositionPatterns(ThingType* type, const Position& position, int& xPattern, int& yPattern, int& zPattern)
 {
-    if(!hasAnimationPhases()) return 0;
+    xPattern = position.x % std::max<int>(type->getNumPatternX(), 1);
+    yPattern = position.y % std::max<int>(type->getNumPatternY(), 1);
+    zPattern = position.z % std::max<int>(type->getNumPatternZ(), 1);
+}
 
-    if(getAnimator() != nullptr) return getAnimator()->getPhase();
+int Item::calculateAsyncAnimationPhase(ThingType* type)
+{
+    const int phases = type->getAnimationPhases();
+    if(phases <= 1) return 0;
 
-    if(m_async) {
-        return (g_clock.millis() % (ITEM_TICKS_PER_FRAME * getAnimationPhases())) / ITEM_TICKS_PER_FRAME;
-    }
+    if(const AnimatorPtr& animator = type->getAnimator()) return animator->getPhase();
 
-    if(g_clock.millis() - m_lastPhase >= ITEM_TICKS_PER_FRAME) {
-        m_phase = (m_phase + 1) % getAnimationPhases();
-        m_lastPhase = g_clock.millis();
+    return (g_clock.millis() % (ITEM_TICKS_PER_FRAME * phases)) / ITEM_TICKS_PER_FRAME;
+}
+
+ticks_t Item::getAsyncNextAnimationTicks(ThingType* type)
+{
+    if(type->getAnimationPhases() <= 1) return std::numeric_limits<ticks_t>::max();
+
+    if(const AnimatorPtr& animator = type->getAnimator()) return animator->getNextPhaseTicks();
+
+    const ticks_t ticks = g_clock.millis();
+    return ticks - ticks % ITEM_TICKS_PER_FRAME + ITEM_TICKS_PER_FRAME;
+}
+
+int Item::calculateAnimationPhase()
+{
+    ThingType* type = rawGetThingType();
+    if(m_async || type->getAnimationPhases() <= 1 || type->getAnimator())
+        return calculateAsyncAnimationPhase(type);
+
+    Extra& state = extra();
+    if(g_clock.millis() - state.lastPhase >= ITEM_TICKS_PER_FRAME) {
+        state.phase = (state.phase + 1) % getAnimationPhases();
+        state.lastPhase = g_clock.millis();
     }
 
-    return m_phase;
+    return state.phase;
+}
+
+ticks_t Item::getNextAnimationTicks()
+{
+    ThingType* type = rawGetThingType();
+    if(m_async || type->getAnimationPhases() <= 1 || type->getAnimator())
+        return getAsyncNextAnimationTicks(type);
+
+    return m_extra ? m_extra->lastPhase + ITEM_TICKS_PER_FRAME : g_clock.millis();
 }
 
 int Item::getExactSize(int layer, int xPattern, int yPattern, int zPattern, int animationPhase)
@@ -71,6 +71,17 @@ enum ItemAttr : uint8
     ATTR_ATTRIBUTE_MAP = 128
 };
 
+// an item that is nothing but its type and count, tiles keep their grounds,
+// borders and walls like this until something needs a real Item
+struct StaticItem
+{
+    uint16 clientId{ 0 };
+    uint16 serverId{ 0 };
+    uint8 countOrSubType{ 1 };
+
+    ThingType* rawGetThingType() const;
+};
+
 // @bindclass
 #pragma pack(push,1) // disable memory alignment
 class Item : public Thing
@@ -81,14 +92,22 @@ public:
 
     static ItemPtr create(int id);
     static ItemPtr createFromOtb(int id);
+    static ItemPtr createFromStatic(const StaticItem& item);
+
+    // ground, borders and walls whose look only depends on their position
+    static bool isStaticType(ThingType* type);
+    static void calculatePositionPatterns(ThingType* type, const Position& position, int& xPattern, int& yPattern, int& zPattern);
+    static int calculateAsyncAnimationPhase(ThingType* type);
+    static ticks_t getAsyncNextAnimationTicks(ThingType* type);
 
     void setId(uint32 id) override;
     void setOtbId(uint16 id);
     void setCountOrSubType(int value) { m_countOrSubType = value; }
     void setCount(int count) { m_countOrSubType = count; }
     void setSubType(int subType) { m_countOrSubType = subType; }
-    void setColor(const Color& c) { m_color = c; }
+    void setColor(const Color& c);
 
+    Color getColor() { return m_extra ? m_extra->color : Color::alpha; }
     int getCountOrSubType() { return m_countOrSubType; }
     int getSubType();
     int getCount();
@@ -101,65 +120,79 @@ public:
     void unserializeItem(const BinaryTreePtr& in);
     void serializeItem(const OutputBinaryTreePtr& out);
 
-    void setDepotId(uint16 depotId) { m_attribs.set(ATTR_DEPOT_ID, depotId); }
-    uint16 getDepotId() { return m_attribs.get<uint16>(ATTR_DEPOT_ID); }
+    void setDepotId(uint16 depotId) { setAttr(ATTR_DEPOT_ID, depotId); }
+    uint16 getDepotId() { return getAttr<uint16>(ATTR_DEPOT_ID); }
 
-    void setDoorId(uint8 doorId) { m_attribs.set(ATTR_HOUSEDOORID, doorId); }
-    uint8 getDoorId() { return m_attribs.get<uint8>(ATTR_HOUSEDOORID); }
+    void setDoorId(uint8 doorId) { setAttr(ATTR_HOUSEDOORID, doorId); }
+    uint8 getDoorId() { return getAttr<uint8>(ATTR_HOUSEDOORID); }
 
-    uint16 getUniqueId() { return m_attribs.get<uint16>(ATTR_ACTION_ID); }
-    uint16 getActionId() { return m_attribs.get<uint16>(ATTR_UNIQUE_ID); }
-    void setActionId(uint16 actionId) { m_attribs.set(ATTR_ACTION_ID, actionId); }
-    void setUniqueId(uint16 uniqueId) { m_attribs.set(ATTR_UNIQUE_ID, uniqueId); }
+    uint16 getUniqueId() { return getAttr<uint16>(ATTR_ACTION_ID); }
+    uint16 getActionId() { return getAttr<uint16>(ATTR_UNIQUE_ID); }
+    void setActionId(uint16 actionId) { setAttr(ATTR_ACTION_ID, actionId); }
+    void setUniqueId(uint16 uniqueId) { setAttr(ATTR_UNIQUE_ID, uniqueId); }
 
-    std::string getText() { return m_attribs.get<std::string>(ATTR_TEXT); }
-    std::string getDescription() { return m_attribs.get<std::string>(ATTR_DESC); }
-    void setDescription(const std::string& desc) { m_attribs.set(ATTR_DESC, desc); }
-    void setText(const std::string& txt) { m_attribs.set(ATTR_TEXT, txt); }
+    std::string getText() { return getAttr<std::string>(ATTR_TEXT); }
+    std::string getDescription() { return getAttr<std::string>(ATTR_DESC); }
+    void setDescription(const std::string& desc) { setAttr(ATTR_DESC, desc); }
+    void setText(const std::string& txt) { setAttr(ATTR_TEXT, txt); }
 
-    Position getTeleportDestination() { return m_attribs.get<Position>(ATTR_TELE_DEST); }
-    void setTeleportDestination(const Position& pos) { m_attribs.set(ATTR_TELE_DEST, pos); }
+    Position getTeleportDestination() { return getAttr<Position>(ATTR_TELE_DEST); }
+    void setTeleportDestination(const Position& pos) { setAttr(ATTR_TELE_DEST, pos); }
 
     void setAsync(bool enable) { m_async = enable; }
 
-    bool isHouseDoor() { return m_attribs.has(ATTR_HOUSEDOORID); }
-    bool isDepot() { return m_attribs.has(ATTR_DEPOT_ID); }
-    bool isContainer() override { return m_attribs.has(ATTR_CONTAINER_ITEMS) || Thing::isContainer(); }
-    bool isDoor() { return m_attribs.has(ATTR_HOUSEDOORID); }
-    bool isTeleport() { return m_attribs.has(ATTR_TELE_DEST); }
+    bool isHouseDoor() { return hasAttr(ATTR_HOUSEDOORID); }
+    bool isDepot() { return hasAttr(ATTR_DEPOT_ID); }
+    bool isContainer() override { return hasAttr(ATTR_CONTAINER_ITEMS) || Thing::isContainer(); }
+    bool isDoor() { return hasAttr(ATTR_HOUSEDOORID); }
+    bool isTeleport() { return hasAttr(ATTR_TELE_DEST); }
 
     ItemPtr clone();
+    bool toStatic(StaticItem& item);
     ItemPtr asItem() { return static_self_cast<Item>(); }
     bool isItem() override { return true; }
 
-    ItemVector getContainerItems() { return m_containerItems; }
-    ItemPtr getContainerItem(int slot) { return m_containerItems[slot]; }
-    void addContainerItemIndexed(const ItemPtr& i, int slot) { m_containerItems[slot] = i; }
-    void addContainerItem(const ItemPtr& i) { m_containerItems.push_back(i); }
-    void removeContainerItem(int slot) { m_containerItems[slot] = nullptr; }
-    void clearContainerItems() { m_containerItems.clear(); }
+    ItemVector getContainerItems() { return m_extra ? m_extra->containerItems : ItemVector(); }
+    ItemPtr getContainerItem(int slot);
+    void addContainerItemIndexed(const ItemPtr& i, int slot);
+    void addContainerItem(const ItemPtr& i) { extra().containerItems.push_back(i); }
+    void removeContainerItem(int slot);
+    void clearContainerItems() { if(m_extra) m_extra->containerItems.clear(); }
 
     void calculatePatterns(int& xPattern, int& yPattern, int& zPattern);
     int calculateAnimationPhase();
+    ticks_t getNextAnimationTicks() override;
     int getExactSize(int layer = 0, int xPattern = 0, int yPattern = 0, int zPattern = 0, int animationPhase = 0) override;
 
     const ThingTypePtr& getThingType() override;
     ThingType* rawGetThingType() override;
 
 private:
+    // per instance state most items never have, map items are mostly grounds,
+    // borders and walls, so it's only allocated once an item needs it
+    struct Extra {
+        Color color{ Color::alpha };
+        stdext::packed_storage<uint8> attribs;
+        ItemVector containerItems;
+        uint8 phase{ 0 };
+        ticks_t lastPhase{ 0 };
+    };
+
+    Extra& extra();
+
+    template<typename T>
+    T getAttr(ItemAttr attr) { return m_extra ? m_extra->attribs.get<T>(attr) : T(); }
+    template<typename T>
+    void setAttr(ItemAttr attr, const T& value) { extra().attribs.set(attr, value); }
+    bool hasAttr(ItemAttr attr) { return m_extra && m_extra->attribs.has(attr); }
+
     uint16 m_clientId{ 0 };
     uint16 m_serverId{ 0 };
     uint8 m_countOrSubType{ 1 };
-    Color m_color{ Color::alpha };
-
-    stdext::packed_storage<uint8> m_attribs;
-    ItemVector m_containerItems;
-
-    uint8 m_phase{ 0 };
-    ticks_t m_lastPhase{ 0 };
-
     bool m_async{ true };
 
+    std::unique_ptr<Extra> m_extra;
+
     friend class ThingPainter;
 };
 
@@ -28,6 +28,12 @@
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 
+ticks_t Missile::getNextAnimationTicks()
+{
+    // moves on every frame
+    return g_clock.millis();
+}
+
 void Missile::setPath(const Position& fromPosition, const Position& toPosition)
 {
     m_position = fromPosition;
@@ -40,6 +40,8 @@ public:
     MissilePtr asMissile() { return static_self_cast<Missile>(); }
     bool isMissile() override { return true; }
 
+    ticks_t getNextAnimationTicks() override;
+
     const ThingTypePtr& getThingType() override;
     ThingType* rawGetThingType() override;
 
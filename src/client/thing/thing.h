@@ -69,6 +69,9 @@ public:
     virtual bool isAnimatedText() { return false; }
     virtual bool isStaticText() { return false; }
 
+    // when the look of this thing changes by itself next, the map is not redrawn before that
+    virtual ticks_t getNextAnimationTicks() { return std::numeric_limits<ticks_t>::max(); }
+
     // type shortcuts
     virtual const ThingTypePtr& getThingType();
     virtual ThingType* rawGetThingType();
@@ -112,6 +112,7 @@ void ThingType::serialize(const FileStreamPtr& fin)
 void ThingType::unserialize(uint16 clientId, ThingCategory category, const FileStreamPtr& fin)
 {
     m_null = false;
+    m_tileFlagsCached = false;
     m_id = clientId;
     m_category = category;
 
@@ -317,6 +318,7 @@ void ThingType::exportImage(const std::string& fileName)
 
 void ThingType::unserializeOtml(const OTMLNodePtr& node)
 {
+    m_tileFlagsCached = false;
     for(const OTMLNodePtr& node2 : node->children()) {
         if(node2->tag() == "opacity")
             m_opacity = node2->value<float>();
@@ -397,17 +399,9 @@ const TexturePtr& ThingType::getTexture(int animationPhase, bool allBlank)
                     }
 
                     Rect drawRect(framePos + Point(m_size.width(), m_size.height()) * SPRITE_SIZE - Point(1), framePos);
-                    for(int fx = framePos.x; fx < framePos.x + m_size.width() * SPRITE_SIZE; ++fx) {
-                        for(int fy = framePos.y; fy < framePos.y + m_size.height() * SPRITE_SIZE; ++fy) {
-                            uint8* p = fullImage->getPixel(fx, fy);
-                            if(p[3] != 0x00) {
-                                drawRect.setTop(std::min<int>(fy, drawRect.top()));
-                                drawRect.setLeft(std::min<int>(fx, drawRect.left()));
-                                drawRect.setBottom(std::max<int>(fy, drawRect.bottom()));
-                                drawRect.setRight(std::max<int>(fx, drawRect.right()));
-                            }
-                        }
-                    }
+                    const Rect opaqueRect = fullImage->getOpaqueRect(Rect(framePos, Size(m_size.width(), m_size.height()) * SPRITE_SIZE));
+                    if(opaqueRect.isValid())
+                        drawRect = opaqueRect;
 
                     m_texturesFramesRects[animationPhase][frameIndex] = drawRect;
                     m_texturesFramesOriginRects[animationPhase][frameIndex] = Rect(framePos, Size(m_size.width(), m_size.height()) * SPRITE_SIZE);
@@ -489,12 +483,43 @@ int ThingType::getExactSize(int layer, int xPattern, int yPattern, int zPattern,
 
 void ThingType::setPathable(bool var)
 {
+    m_tileFlagsCached = false;
     if(var == true)
         m_attribs.remove(ThingAttrNotPathable);
     else
         m_attribs.set(ThingAttrNotPathable, true);
 }
 
+uint32 ThingType::updateTileFlags()
+{
+    // tiles update their counters on every thing added or removed, testing each
+    // property there would cost a virtual call and an attribute lookup apiece
+    const auto flag = [](TileThingFlag flag, bool value) -> uint32 { return value ? 1u << flag : 0; };
+
+    m_tileFlags = flag(TileThingDisplacement, hasDisplacement())
+        | flag(TileThingCommon, !isGround() && !isGroundBorder() && !isOnTop() && !isOnBottom())
+        | flag(TileThingTop, isOnTop())
+        | flag(TileThingGroundOrBorder, isGround() || isGroundBorder())
+        | flag(TileThingBottom, isOnBottom())
+        | flag(TileThingHookSouth, isOnBottom() && isHookSouth())
+        | flag(TileThingHookEast, isOnBottom() && isHookEast())
+        | flag(TileThingTranslucent, isTranslucent() || hasLensHelp())
+        | flag(TileThingNotSingleDimension, getHeight() != 1 || getWidth() != 1)
+        | flag(TileThingTall, getHeight() > 1)
+        | flag(TileThingWide, getWidth() > 1)
+        | flag(TileThingNotWalkable, isNotWalkable())
+        | flag(TileThingNotPathable, isNotPathable())
+        | flag(TileThingBlockProjectile, blockProjectile())
+        | flag(TileThingFullGround, isFullGround())
+        | flag(TileThingElevation, hasElevation())
+        | flag(TileThingOpaque, isOpaque())
+        | flag(TileThingTopGround, isGround() && !isFullGround() && blockProjectile() && getWidth() != 1 && getHeight() != 1)
+        | flag(TileThingNotWalkableEdge, isGroundBorder() && isNotWalkable())
+        | flag(TileThingAnimated, getAnimationPhases() > 1);
+    m_tileFlagsCached = true;
+    return m_tileFlags;
+}
+
 int ThingType::getAnimationPhases()
 {
     if(m_animator) return m_animator->getAnimationPhases();
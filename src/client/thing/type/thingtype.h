@@ -126,6 +126,36 @@ struct Light {
     float brightness = 1.f;
 };
 
+// what a thing adds to the tile holding it, bit indexes of ThingType::getTileFlags()
+enum TileThingFlag : uint8 {
+    TileThingDisplacement = 0,
+    TileThingCommon,
+    TileThingTop,
+    TileThingGroundOrBorder,
+    TileThingBottom,
+    TileThingHookSouth,
+    TileThingHookEast,
+    TileThingTranslucent,
+    TileThingNotSingleDimension,
+    TileThingTall,
+    TileThingWide,
+    // only counted for items
+    TileThingNotWalkable,
+    TileThingNotPathable,
+    TileThingBlockProjectile,
+    TileThingFullGround,
+    TileThingElevation,
+    TileThingOpaque,
+    TileThingTopGround,
+    TileThingNotWalkableEdge,
+    TileThingAnimated,
+    // not given by the type
+    TileThingLight,
+    TileThingCreature,
+    TileThingTranslucentLight,
+    TileThingLast
+};
+
 class ThingType : public LuaObject
 {
 public:
@@ -220,6 +250,7 @@ public:
     float getOpacity() { return m_opacity; }
     bool isNotPreWalkable() { return m_attribs.has(ThingAttrNotPreWalkable); }
     void setPathable(bool var);
+    uint32 getTileFlags() { return m_tileFlagsCached ? m_tileFlags : updateTileFlags(); }
     int getExactHeight();
     const TexturePtr& getTexture(int animationPhase, bool allBlank = false);
 
@@ -230,6 +261,7 @@ private:
 
     bool hasTexture() const { return !m_textures.empty(); }
 
+    uint32 updateTileFlags();
     uint getSpriteIndex(int w, int h, int l, int x, int y, int z, int a);
     uint getTextureIndex(int l, int x, int y, int z);
 
@@ -237,6 +269,8 @@ private:
     uint16 m_id{ 0 };
     bool m_null{ true };
     stdext::dynamic_storage<uint8> m_attribs;
+    uint32 m_tileFlags{ 0 };
+    bool m_tileFlagsCached{ false };
 
     Size m_size;
     Point m_displacement;
@@ -52,6 +52,7 @@ public:
     void setDrawNames(bool enable) { m_mapView->setDrawNames(enable); }
     void setDrawHealthBars(bool enable) { m_mapView->setDrawHealthBars(enable); }
     void setDrawLights(bool enable) { m_mapView->setDrawLights(enable); }
+    void setLightMode(const MapView::LightMode mode) { m_mapView->setLightMode(mode); }
     void setDrawViewportEdge(bool enable) { m_mapView->setDrawViewportEdge(enable); }
     void setDrawManaBar(bool enable) { m_mapView->setDrawManaBar(enable); }
     void setKeepAspectRatio(bool enable);
@@ -68,6 +69,7 @@ public:
     bool isDrawingNames() { return m_mapView->isDrawingNames(); }
     bool isDrawingHealthBars() { return m_mapView->isDrawingHealthBars(); }
     bool isDrawingLights() { return m_mapView->isDrawingLights(); }
+    MapView::LightMode getLightMode() { return m_mapView->getLightMode(); }
     bool isDrawingViewportEdge() { return m_mapView->isDrawingViewportEdge(); }
     bool isDrawingManaBar() { return m_mapView->isDrawingManaBar(); }
     bool isKeepAspectRatioEnabled() { return m_keepAspectRatio; }
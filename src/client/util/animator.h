@@ -49,6 +49,7 @@ public:
     void resetAnimation();
 
     int getPhase();
+    ticks_t getNextPhaseTicks() const { return m_isComplete ? std::numeric_limits<ticks_t>::max() : m_lastPhaseTicks + m_currentDuration; }
 
     int getPhaseAt(ticks_t time);
     int getStartPhase() const;
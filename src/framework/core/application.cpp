@@ -79,6 +79,11 @@ void Application::init(std::vector<std::string>& args)
 
     g_asyncDispatcher.init();
 
+#ifdef FW_NET
+    // initialize network
+    Connection::init();
+#endif
+
     std::string startupOptions;
     for(uint i = 1; i < args.size(); ++i) {
         const std::string& arg = args[i];
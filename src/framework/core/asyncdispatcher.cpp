@@ -26,7 +26,10 @@ AsyncDispatcher g_asyncDispatcher;
 
 void AsyncDispatcher::init()
 {
-    spawn_thread();
+    // a few workers, so independent jobs such as texture decoding run in parallel
+    const int threads = std::max<int>(1, std::min<int>(4, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    for(int i = 0; i < threads; ++i)
+        spawn_thread();
 }
 
 void AsyncDispatcher::terminate()
@@ -59,7 +62,8 @@ void AsyncDispatcher::exec_loop()
         while(m_tasks.empty() && m_running)
             m_condition.wait(lock);
 
-        if(!m_running)
+        // work already queued (e.g. files being written) is finished before stopping
+        if(m_tasks.empty())
             return;
 
         std::function<void()> task = m_tasks.front();
@@ -21,6 +21,8 @@
  */
 
 #include "config.h"
+#include "asyncdispatcher.h"
+#include "eventdispatcher.h"
 #include "resourcemanager.h"
 #include "configmanager.h"
 
@@ -30,6 +32,7 @@ Config::Config()
 {
     m_confsDoc = OTMLDocument::create();
     m_fileName = "";
+    m_saveState = std::make_shared<SaveState>();
 }
 
 bool Config::load(const std::string& file)
@@ -41,8 +44,10 @@ bool Config::load(const std::string& file)
 
     try {
         const OTMLDocumentPtr confsDoc = OTMLDocument::parse(file);
-        if(confsDoc)
+        if(confsDoc) {
             m_confsDoc = confsDoc;
+            indexNodes();
+        }
         return true;
     } catch(stdext::exception& e) {
         g_logger.error(stdext::format("Unable to parse configuration file '%s': ", e.what()));
@@ -52,8 +57,15 @@ bool Config::load(const std::string& file)
 
 bool Config::unload()
 {
+    // changes still waiting for the delayed save or for a background write are written before they are lost
+    if(m_saveEvent || hasUnsavedChanges())
+        saveNow();
+    else
+        checkFailedSave();
+
     if(isLoaded()) {
         m_confsDoc = nullptr;
+        m_nodes.clear();
         m_fileName = "";
         return true;
     }
@@ -64,12 +76,45 @@ bool Config::save()
 {
     if(m_fileName.length() == 0)
         return false;
-    return m_confsDoc->save(m_fileName);
+
+    if(m_saveEvent) {
+        m_saveEvent->cancel();
+        m_saveEvent = nullptr;
+    }
+
+    // the document is emitted here, only the file writing is left to the worker
+    const SaveStatePtr state = m_saveState;
+    const uint64 version = ++m_saveVersion;
+    const std::string fileName = m_fileName;
+    const std::string contents = m_confsDoc->emit();
+    g_asyncDispatcher.schedule([=] { return writeFile(state, version, fileName, contents); });
+
+    // background writes can't report back, a failure shows up on the next save
+    return !checkFailedSave();
+}
+
+bool Config::saveNow()
+{
+    if(m_fileName.length() == 0)
+        return false;
+
+    if(m_saveEvent) {
+        m_saveEvent->cancel();
+        m_saveEvent = nullptr;
+    }
+
+    if(!writeFile(m_saveState, ++m_saveVersion, m_fileName, m_confsDoc->emit())) {
+        checkFailedSave();
+        return false;
+    }
+    return true;
 }
 
 void Config::clear()
 {
     m_confsDoc->clear();
+    m_nodes.clear();
+    scheduleSave();
 }
 
 void Config::setValue(const std::string& key, const std::string& value)
@@ -79,8 +124,16 @@ void Config::setValue(const std::string& key, const std::string& value)
         return;
     }
 
-    const OTMLNodePtr child = OTMLNode::create(key, value);
-    m_confsDoc->addChild(child);
+    const auto it = m_nodes.find(key);
+    if(it != m_nodes.end() && !it->second->hasChildren()) {
+        if(it->second->value() != value) {
+            it->second->setValue(value);
+            scheduleSave();
+        }
+        return;
+    }
+
+    addNode(OTMLNode::create(key, value));
 }
 
 void Config::setList(const std::string& key, const std::vector<std::string>& list)
@@ -93,17 +146,17 @@ void Config::setList(const std::string& key, const std::vector<std::string>& lis
     OTMLNodePtr child = OTMLNode::create(key, true);
     for(const std::string& value : list)
         child->writeIn(value);
-    m_confsDoc->addChild(child);
+    addNode(child);
 }
 
 bool Config::exists(const std::string& key)
 {
-    return m_confsDoc->hasChildAt(key);
+    return m_nodes.find(key) != m_nodes.end();
 }
 
 std::string Config::getValue(const std::string& key)
 {
-    OTMLNodePtr child = m_confsDoc->get(key);
+    const OTMLNodePtr child = getNode(key);
     if(child)
         return child->value();
     return "";
@@ -112,7 +165,7 @@ std::string Config::getValue(const std::string& key)
 std::vector<std::string> Config::getList(const std::string& key)
 {
     std::vector<std::string> list;
-    OTMLNodePtr child = m_confsDoc->get(key);
+    const OTMLNodePtr child = getNode(key);
     if(child) {
         for(const OTMLNodePtr& subchild : child->children())
             list.push_back(subchild->value());
@@ -120,11 +173,42 @@ std::vector<std::string> Config::getList(const std::string& key)
     return list;
 }
 
+int Config::getInteger(const std::string& key, int def)
+{
+    const OTMLNodePtr child = getNode(key);
+    int value;
+    if(child && stdext::cast(child->value(), value))
+        return value;
+    return def;
+}
+
+double Config::getNumber(const std::string& key, double def)
+{
+    const OTMLNodePtr child = getNode(key);
+    double value;
+    if(child && stdext::cast(child->value(), value))
+        return value;
+    return def;
+}
+
+bool Config::getBoolean(const std::string& key, bool def)
+{
+    const OTMLNodePtr child = getNode(key);
+    bool value;
+    if(child && stdext::cast(child->value(), value))
+        return value;
+    return def;
+}
+
 void Config::remove(const std::string& key)
 {
-    const OTMLNodePtr child = m_confsDoc->get(key);
-    if(child)
-        m_confsDoc->removeChild(child);
+    const auto it = m_nodes.find(key);
+    if(it == m_nodes.end())
+        return;
+
+    m_confsDoc->removeChild(it->second);
+    m_nodes.erase(it);
+    scheduleSave();
 }
 
 void Config::setNode(const std::string& key, const OTMLNodePtr& node)
@@ -136,14 +220,17 @@ void Config::setNode(const std::string& key, const OTMLNodePtr& node)
 void Config::mergeNode(const std::string& key, const OTMLNodePtr& node)
 {
     OTMLNodePtr clone = node->clone();
-    node->setTag(key);
-    node->setUnique(true);
-    m_confsDoc->addChild(node);
+    clone->setTag(key);
+    clone->setUnique(true);
+    addNode(clone);
 }
 
 OTMLNodePtr Config::getNode(const std::string& key)
 {
-    return m_confsDoc->get(key);
+    const auto it = m_nodes.find(key);
+    if(it != m_nodes.end())
+        return it->second;
+    return nullptr;
 }
 
 bool Config::isLoaded()
@@ -155,3 +242,72 @@ std::string Config::getFileName()
 {
     return m_fileName;
 }
+
+void Config::indexNodes()
+{
+    // lookups by key used to be linear searches over the document children
+    m_nodes.clear();
+    for(const OTMLNodePtr& child : m_confsDoc->children()) {
+        if(!child->isNull())
+            m_nodes.emplace(child->tag(), child);
+    }
+}
+
+void Config::addNode(const OTMLNodePtr& node)
+{
+    // unique nodes replace, or merge into, the node already using the key
+    m_confsDoc->addChild(node);
+    m_nodes[node->tag()] = node;
+    scheduleSave();
+}
+
+void Config::scheduleSave()
+{
+    // changes usually come in bursts, the file is written once they settle
+    if(m_fileName.empty() || m_saveEvent)
+        return;
+
+    const ConfigPtr self = asConfig();
+    m_saveEvent = g_dispatcher.scheduleEvent([self] {
+        self->m_saveEvent = nullptr;
+        self->save();
+    }, SAVE_DELAY);
+}
+
+bool Config::hasUnsavedChanges()
+{
+    std::lock_guard<std::mutex> lock(m_saveState->mutex);
+    return m_saveVersion > m_saveState->savedVersion;
+}
+
+bool Config::checkFailedSave()
+{
+    std::lock_guard<std::mutex> lock(m_saveState->mutex);
+    if(m_saveState->error.empty())
+        return false;
+
+    g_logger.error(stdext::format("Unable to save configuration file '%s': %s", m_fileName, m_saveState->error));
+    m_saveState->error.clear();
+    return true;
+}
+
+bool Config::writeFile(const SaveStatePtr& state, uint64 version, const std::string& fileName, const std::string& contents)
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    // a newer version was already written meanwhile
+    if(version <= state->savedVersion)
+        return true;
+
+    // written aside and renamed over the old file, so a crash never leaves it truncated
+    const std::string tmpFileName = fileName + ".tmp";
+    std::string error;
+    if(!g_resources.writeFileBuffer(tmpFileName, (const uchar*)contents.data(), contents.size(), error) || !g_resources.renameFile(tmpFileName, fileName, error)) {
+        state->error = error;
+        return false;
+    }
+
+    state->savedVersion = version;
+    state->error.clear();
+    return true;
+}
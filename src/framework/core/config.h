@@ -27,6 +27,7 @@
 
 #include <framework/luaengine/luaobject.h>
 #include <framework/otml/declarations.h>
+#include <framework/stdext/thread.h>
 
  // @bindclass
 class Config : public LuaObject
@@ -34,9 +35,14 @@ class Config : public LuaObject
 public:
     Config();
 
+    enum {
+        SAVE_DELAY = 1000
+    };
+
     bool load(const std::string& file);
     bool unload();
     bool save();
+    bool saveNow();
     void clear();
 
     void setValue(const std::string& key, const std::string& value);
@@ -44,6 +50,10 @@ public:
     std::string getValue(const std::string& key);
     std::vector<std::string> getList(const std::string& key);
 
+    int getInteger(const std::string& key, int def);
+    double getNumber(const std::string& key, double def);
+    bool getBoolean(const std::string& key, bool def);
+
     void setNode(const std::string& key, const OTMLNodePtr& node);
     void mergeNode(const std::string& key, const OTMLNodePtr& node);
     OTMLNodePtr getNode(const std::string& key);
@@ -58,8 +68,26 @@ public:
     ConfigPtr asConfig() { return static_self_cast<Config>(); }
 
 private:
+    struct SaveState {
+        std::mutex mutex;
+        uint64 savedVersion{ 0 };
+        std::string error; // last background write failure, logged from the main thread
+    };
+    using SaveStatePtr = std::shared_ptr<SaveState>;
+
+    void indexNodes();
+    void addNode(const OTMLNodePtr& node);
+    void scheduleSave();
+    bool hasUnsavedChanges();
+    bool checkFailedSave();
+    static bool writeFile(const SaveStatePtr& state, uint64 version, const std::string& fileName, const std::string& contents);
+
     std::string m_fileName;
     OTMLDocumentPtr m_confsDoc;
+    std::unordered_map<std::string, OTMLNodePtr> m_nodes;
+    ScheduledEventPtr m_saveEvent;
+    SaveStatePtr m_saveState;
+    uint64 m_saveVersion{ 0 };
 };
 
 #endif
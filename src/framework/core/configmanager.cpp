@@ -32,8 +32,8 @@ void ConfigManager::init()
 void ConfigManager::terminate()
 {
     if(m_settings) {
-        // ensure settings are saved
-        m_settings->save();
+        // ensure settings are saved, the async dispatcher is already gone
+        m_settings->saveNow();
 
         m_settings->unload();
         m_settings = nullptr;
@@ -46,4 +46,7 @@ using OutputBinaryTreePtr = stdext::shared_object_ptr<OutputBinaryTree>;
 
 using BinaryTreeVec = std::vector<BinaryTreePtr>;
 
+// handle of an interned resource path, see ResourceManager::getResourceId
+using ResourceId = uint32;
+
 #endif
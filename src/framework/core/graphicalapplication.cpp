@@ -75,6 +75,9 @@ void GraphicalApplication::deinit()
     // hide the window because there is no render anymore
     g_window.hide();
 
+    // the async dispatcher finishes its queue when stopped, textures would no longer be shown
+    g_textures.cancelDecodes();
+
     Application::deinit();
 }
 
@@ -196,10 +199,20 @@ void GraphicalApplication::run()
                 g_lua.callGlobalField("g_app", "onFps", m_backgroundFrameCounter.getLastFps());
             m_foregroundFrameCounter.update();
 
+            // collect lua garbage at the end of the frame, in the idle time left before the next one
+            if(redraw) {
+                int gcBudget = g_lua.getGarbageCollectorBudget();
+                if(m_backgroundFrameCounter.isFpsLimitActive())
+                    gcBudget = std::min<int>(gcBudget, m_backgroundFrameCounter.getMaximumSleepMicros());
+                g_lua.stepGarbageCollector(gcBudget);
+            }
+
             const int sleepMicros = m_backgroundFrameCounter.getMaximumSleepMicros();
             if(sleepMicros >= AdaptativeFrameCounter::MINIMUM_MICROS_SLEEP)
                 stdext::microsleep(sleepMicros);
         } else {
+            g_lua.stepGarbageCollector(g_lua.getGarbageCollectorBudget());
+
             // sleeps until next poll to avoid massive cpu usage
             stdext::millisleep(POLL_CYCLE_DELAY + 1);
             g_clock.update();
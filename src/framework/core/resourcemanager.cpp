@@ -198,16 +198,28 @@ std::string ResourceManager::readFileContents(const std::string& fileName)
 }
 
 bool ResourceManager::writeFileBuffer(const std::string& fileName, const uchar* data, uint size)
+{
+    std::string error;
+    if(!writeFileBuffer(fileName, data, size, error)) {
+        g_logger.error(error);
+        return false;
+    }
+    return true;
+}
+
+bool ResourceManager::writeFileBuffer(const std::string& fileName, const uchar* data, uint size, std::string& error)
 {
     PHYSFS_file* file = PHYSFS_openWrite(fileName.c_str());
     if(!file) {
-        g_logger.error(PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+        error = stdext::format("unable to write file '%s': %s", fileName, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
         return false;
     }
 
-    PHYSFS_writeBytes(file, data, size);
+    const bool written = PHYSFS_writeBytes(file, data, size) == size;
+    if(!written)
+        error = stdext::format("unable to write file '%s': %s", fileName, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
     PHYSFS_close(file);
-    return true;
+    return written;
 }
 
 bool ResourceManager::writeFileStream(const std::string& fileName, std::iostream& in)
@@ -259,6 +271,28 @@ bool ResourceManager::deleteFile(const std::string& fileName)
     return PHYSFS_delete(resolvePath(fileName).c_str()) != 0;
 }
 
+bool ResourceManager::renameFile(const std::string& fileName, const std::string& newFileName, std::string& error)
+{
+    // physfs can't rename, files are renamed straight in the write directory
+    const char* writeDir = PHYSFS_getWriteDir();
+    if(!writeDir) {
+        error = "no write directory";
+        return false;
+    }
+
+    const auto realPath = [writeDir](const std::string& name) {
+        return fs::path(writeDir) / name.substr(std::min<size_t>(name.find_first_not_of('/'), name.size()));
+    };
+
+    try {
+        fs::rename(realPath(fileName), realPath(newFileName));
+        return true;
+    } catch(fs::filesystem_error& e) {
+        error = stdext::format("unable to rename file '%s' to '%s': %s", fileName, newFileName, e.what());
+        return false;
+    }
+}
+
 bool ResourceManager::makeDir(const std::string& directory)
 {
     return PHYSFS_mkdir(directory.c_str());
@@ -324,6 +358,26 @@ std::string ResourceManager::resolvePath(const std::string& path)
     return fullPath;
 }
 
+ResourceId ResourceManager::getResourceId(const std::string& path)
+{
+    // clean absolute paths, the common case, don't need the running script path
+    if(!stdext::starts_with(path, "/") || path.find("//") != std::string::npos)
+        return internPath(resolvePath(path));
+    return internPath(path);
+}
+
+ResourceId ResourceManager::internPath(const std::string& fullPath)
+{
+    const auto it = m_resourceIds.find(fullPath);
+    if(it != m_resourceIds.end())
+        return it->second;
+
+    const auto id = static_cast<ResourceId>(m_resourcePaths.size());
+    m_resourcePaths.push_back(fullPath);
+    m_resourceIds.emplace(fullPath, id);
+    return id;
+}
+
 std::string ResourceManager::getRealDir(const std::string& path)
 {
     std::string dir;
@@ -54,6 +54,9 @@ public:
     std::string readFileContents(const std::string& fileName);
     // @dontbind
     bool writeFileBuffer(const std::string& fileName, const uchar* data, uint size);
+    // doesn't log, the failure reason is left in error, so it can be used from worker threads
+    // @dontbind
+    bool writeFileBuffer(const std::string& fileName, const uchar* data, uint size, std::string& error);
     bool writeFileContents(const std::string& fileName, const std::string& data);
     // @dontbind
     bool writeFileStream(const std::string& fileName, std::iostream& in);
@@ -62,6 +65,8 @@ public:
     FileStreamPtr appendFile(const std::string& fileName);
     FileStreamPtr createFile(const std::string& fileName);
     bool deleteFile(const std::string& fileName);
+    // @dontbind
+    bool renameFile(const std::string& fileName, const std::string& newFileName, std::string& error);
 
     bool makeDir(const std::string& directory);
     std::list<std::string> listDirectoryFiles(const std::string& directoryPath = "");
@@ -76,17 +81,26 @@ public:
     std::string getWorkDir() { return m_workDir; }
     std::deque<std::string> getSearchPaths() { return m_searchPaths; }
 
+    // resolves a path once and interns it, the same resource always maps to the same small id
+    // @dontbind
+    ResourceId getResourceId(const std::string& path);
+    // @dontbind
+    const std::string& getResourcePath(ResourceId id) { return m_resourcePaths[id]; }
+
     std::string guessFilePath(const std::string& filename, const std::string& type);
     bool isFileType(const std::string& filename, const std::string& type);
     ticks_t getFileTime(const std::string& filename);
 
 protected:
     std::vector<std::string> discoverPath(const fs::path& path, bool filenameOnly, bool recursive);
+    ResourceId internPath(const std::string& fullPath);
 
 private:
     std::string m_workDir;
     std::string m_writeDir;
     std::deque<std::string> m_searchPaths;
+    std::unordered_map<std::string, ResourceId> m_resourceIds;
+    std::deque<std::string> m_resourcePaths;
 };
 
 extern ResourceManager g_resources;
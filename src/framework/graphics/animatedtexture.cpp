@@ -28,10 +28,19 @@
 #include <utility>
 
 AnimatedTexture::AnimatedTexture(const Size& size, const std::vector<ImagePtr>& frames, std::vector<int> framesDelay, bool buildMipmaps, bool compress)
+{
+    setFrames(size, frames, std::move(framesDelay), buildMipmaps, compress);
+}
+
+AnimatedTexture::~AnimatedTexture()
+= default;
+
+void AnimatedTexture::setFrames(const Size& size, const std::vector<ImagePtr>& frames, std::vector<int> framesDelay, bool buildMipmaps, bool compress)
 {
     if(!setupSize(size, buildMipmaps))
         return;
 
+    m_frames.clear();
     for(const auto& frame : frames) {
         m_frames.push_back(new Texture(frame, buildMipmaps, compress));
     }
@@ -43,11 +52,11 @@ AnimatedTexture::AnimatedTexture(const Size& size, const std::vector<ImagePtr>&
     m_animTimer.restart();
 }
 
-AnimatedTexture::~AnimatedTexture()
-= default;
-
 bool AnimatedTexture::buildHardwareMipmaps()
 {
+    if(m_frames.empty())
+        return Texture::buildHardwareMipmaps();
+
     if(!g_graphics.canUseHardwareMipmaps())
         return false;
     for(const TexturePtr& frame : m_frames)
@@ -58,6 +67,11 @@ bool AnimatedTexture::buildHardwareMipmaps()
 
 void AnimatedTexture::setSmooth(bool smooth)
 {
+    if(m_frames.empty()) {
+        Texture::setSmooth(smooth);
+        return;
+    }
+
     for(const TexturePtr& frame : m_frames)
         frame->setSmooth(smooth);
     m_smooth = smooth;
@@ -65,6 +79,11 @@ void AnimatedTexture::setSmooth(bool smooth)
 
 void AnimatedTexture::setRepeat(bool repeat)
 {
+    if(m_frames.empty()) {
+        Texture::setRepeat(repeat);
+        return;
+    }
+
     for(const TexturePtr& frame : m_frames)
         frame->setRepeat(repeat);
     m_repeat = repeat;
@@ -72,6 +91,9 @@ void AnimatedTexture::setRepeat(bool repeat)
 
 void AnimatedTexture::updateAnimation()
 {
+    if(m_frames.empty())
+        return;
+
     if(m_animTimer.ticksElapsed() < m_framesDelay[m_currentFrame])
         return;
 
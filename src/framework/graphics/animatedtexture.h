@@ -29,9 +29,13 @@
 class AnimatedTexture : public Texture
 {
 public:
+    /// Behaves as a plain texture until frames are set, so it can be handed out before decoding
+    AnimatedTexture() = default;
     AnimatedTexture(const Size& size, const std::vector<ImagePtr>& frames, std::vector<int> framesDelay, bool buildMipmaps = false, bool compress = false);
     ~AnimatedTexture() override;
 
+    void setFrames(const Size& size, const std::vector<ImagePtr>& frames, std::vector<int> framesDelay, bool buildMipmaps = false, bool compress = false);
+
     bool buildHardwareMipmaps() override;
 
     void setSmooth(bool smooth) override;
@@ -39,12 +43,12 @@ public:
 
     void updateAnimation();
 
-    bool isAnimatedTexture() override { return true; }
+    bool isAnimatedTexture() override { return !m_frames.empty(); }
 
 private:
     std::vector<TexturePtr> m_frames;
     std::vector<int> m_framesDelay;
-    uint m_currentFrame;
+    uint m_currentFrame{ 0 };
     Timer m_animTimer;
 };
 
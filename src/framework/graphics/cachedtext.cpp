@@ -36,6 +36,23 @@ void CachedText::draw(const Rect& rect)
     if(!m_font)
         return;
 
+    updateCoords(rect);
+
+    if(m_font->getTexture())
+        g_painter->drawTextureCoords(m_textCoordsBuffer, m_font->getTexture());
+}
+
+void CachedText::appendCoords(CoordsBuffer& coordsBuffer, const Rect& rect)
+{
+    if(!m_font)
+        return;
+
+    updateCoords(rect);
+    coordsBuffer.append(m_textCoordsBuffer);
+}
+
+void CachedText::updateCoords(const Rect& rect)
+{
     if(m_textMustRecache || m_textCachedScreenCoords != rect) {
         m_textMustRecache = false;
         m_textCachedScreenCoords = rect;
@@ -43,9 +60,6 @@ void CachedText::draw(const Rect& rect)
         m_textCoordsBuffer.clear();
         m_font->calculateDrawTextCoords(m_textCoordsBuffer, m_text, rect, Fw::AlignCenter);
     }
-
-    if(m_font->getTexture())
-        g_painter->drawTextureCoords(m_textCoordsBuffer, m_font->getTexture());
 }
 
 void CachedText::update()
@@ -32,6 +32,8 @@ public:
     CachedText();
 
     void draw(const Rect& rect);
+    /// Adds the text coords to a buffer drawn later with the font texture, to draw many texts at once
+    void appendCoords(CoordsBuffer& coordsBuffer, const Rect& rect);
 
     void wrapText(int maxWidth);
     void setFont(const BitmapFontPtr& font) { m_font = font; update(); }
@@ -45,6 +47,7 @@ public:
 
 private:
     void update();
+    void updateCoords(const Rect& rect);
 
     std::string m_text;
     Size m_textSize;
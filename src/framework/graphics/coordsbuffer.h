@@ -71,6 +71,13 @@ public:
         m_hardwareCached = false;
     }
 
+    void append(const CoordsBuffer& other)
+    {
+        m_vertexArray.append(other.m_vertexArray);
+        m_textureCoordArray.append(other.m_textureCoordArray);
+        m_hardwareCached = false;
+    }
+
     void addBoudingRect(const Rect& dest, int innerLineWidth);
     void addRepeatedRects(const Rect& dest, const Rect& src);
 
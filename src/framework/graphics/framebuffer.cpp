@@ -80,6 +80,9 @@ void FrameBuffer::resize(const Size& size)
     m_texture->setSmooth(m_smooth);
     m_texture->setUpsideDown(true);
 
+    // the new texture holds nothing, whoever draws on it must not wait for a timed update
+    m_forceUpdate = true;
+
     if(m_fbo) {
         internalBind();
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture->getId(), 0);
@@ -58,6 +58,7 @@ public:
     bool isSmooth() { return m_smooth; }
 
     bool canUpdate();
+    bool hasPendingUpdate() { return m_forceUpdate; }
     void update();
     void cleanTexture() { m_texture = nullptr; }
 
@@ -28,6 +28,289 @@
 
 #include "framework/stdext/math.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define IMAGE_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON)
+#define IMAGE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // kernels work on whole RGBA pixels, words are built from bytes so the layout does not depend on endianness
+    uint32 toPixel(uint8 r, uint8 g, uint8 b, uint8 a)
+    {
+        const uint8 bytes[4] = { r, g, b, a };
+        uint32 pixel;
+        memcpy(&pixel, bytes, 4);
+        return pixel;
+    }
+
+    uint32 toPixel(const Color& color) { return toPixel(color.r(), color.g(), color.b(), color.a()); }
+
+    uint32 loadPixel(const uint8* p) { uint32 pixel; memcpy(&pixel, p, 4); return pixel; }
+    void storePixel(uint8* p, uint32 pixel) { memcpy(p, &pixel, 4); }
+
+    // pixels equal to match become equal, every other pixel becomes notEqual
+    void replaceScalar(uint8* pixels, size_t count, uint32 match, uint32 equal, uint32 notEqual)
+    {
+        for(size_t i = 0; i < count; ++i, pixels += 4)
+            storePixel(pixels, loadPixel(pixels) == match ? equal : notEqual);
+    }
+
+    // copies the pixels of src that are not fully transparent
+    void blitScalar(uint8* dst, const uint8* src, size_t count, uint32 alphaMask)
+    {
+        for(size_t i = 0; i < count; ++i, dst += 4, src += 4) {
+            const uint32 pixel = loadPixel(src);
+            if(pixel & alphaMask)
+                storePixel(dst, pixel);
+        }
+    }
+
+    bool isOpaque(const uint8* pixel) { return pixel[3] != 0; }
+
+#if !defined(IMAGE_SSE2) && !defined(IMAGE_NEON)
+    // finds the first and last pixels that are not fully transparent
+    bool opaqueSpanScalar(const uint8* pixels, size_t count, uint32, size_t& first, size_t& last)
+    {
+        size_t i = 0;
+        while(i < count && !isOpaque(pixels + i * 4))
+            ++i;
+        if(i == count)
+            return false;
+        first = i;
+
+        size_t j = count;
+        while(!isOpaque(pixels + (j - 1) * 4))
+            --j;
+        last = j - 1;
+        return true;
+    }
+#endif
+
+#if defined(IMAGE_SSE2)
+    void replaceSSE2(uint8* pixels, size_t count, uint32 match, uint32 equal, uint32 notEqual)
+    {
+        const __m128i vMatch = _mm_set1_epi32(static_cast<int>(match));
+        const __m128i vEqual = _mm_set1_epi32(static_cast<int>(equal));
+        const __m128i vNotEqual = _mm_set1_epi32(static_cast<int>(notEqual));
+
+        size_t i = 0;
+        for(; i + 4 <= count; i += 4) {
+            __m128i* p = reinterpret_cast<__m128i*>(pixels + i * 4);
+            const __m128i mask = _mm_cmpeq_epi32(_mm_loadu_si128(p), vMatch);
+            _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(mask, vEqual), _mm_andnot_si128(mask, vNotEqual)));
+        }
+        replaceScalar(pixels + i * 4, count - i, match, equal, notEqual);
+    }
+
+    void blitSSE2(uint8* dst, const uint8* src, size_t count, uint32 alphaMask)
+    {
+        const __m128i vAlpha = _mm_set1_epi32(static_cast<int>(alphaMask));
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for(; i + 4 <= count; i += 4) {
+            __m128i* d = reinterpret_cast<__m128i*>(dst + i * 4);
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(s, vAlpha), zero);
+            _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(transparent, _mm_loadu_si128(d)), _mm_andnot_si128(transparent, s)));
+        }
+        blitScalar(dst + i * 4, src + i * 4, count - i, alphaMask);
+    }
+
+    bool hasOpaqueSSE2(const uint8* pixels, __m128i vAlpha)
+    {
+        const __m128i alpha = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)), vAlpha);
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) != 0xFFFF;
+    }
+
+    bool opaqueSpanSSE2(const uint8* pixels, size_t count, uint32 alphaMask, size_t& first, size_t& last)
+    {
+        const __m128i vAlpha = _mm_set1_epi32(static_cast<int>(alphaMask));
+
+        size_t i = 0;
+        while(i + 4 <= count && !hasOpaqueSSE2(pixels + i * 4, vAlpha))
+            i += 4;
+        while(i < count && !isOpaque(pixels + i * 4))
+            ++i;
+        if(i == count)
+            return false;
+        first = i;
+
+        // a skipped block never contains first, so the scalar loop always stops
+        size_t j = count;
+        while(j >= first + 4 && !hasOpaqueSSE2(pixels + (j - 4) * 4, vAlpha))
+            j -= 4;
+        while(!isOpaque(pixels + (j - 1) * 4))
+            --j;
+        last = j - 1;
+        return true;
+    }
+#endif
+
+#if defined(IMAGE_AVX2)
+#if defined(__GNUC__)
+#define IMAGE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define IMAGE_AVX2_TARGET
+#endif
+
+    IMAGE_AVX2_TARGET void replaceAVX2(uint8* pixels, size_t count, uint32 match, uint32 equal, uint32 notEqual)
+    {
+        const __m256i vMatch = _mm256_set1_epi32(static_cast<int>(match));
+        const __m256i vEqual = _mm256_set1_epi32(static_cast<int>(equal));
+        const __m256i vNotEqual = _mm256_set1_epi32(static_cast<int>(notEqual));
+
+        size_t i = 0;
+        for(; i + 8 <= count; i += 8) {
+            __m256i* p = reinterpret_cast<__m256i*>(pixels + i * 4);
+            const __m256i mask = _mm256_cmpeq_epi32(_mm256_loadu_si256(p), vMatch);
+            _mm256_storeu_si256(p, _mm256_blendv_epi8(vNotEqual, vEqual, mask));
+        }
+        replaceSSE2(pixels + i * 4, count - i, match, equal, notEqual);
+    }
+
+    IMAGE_AVX2_TARGET void blitAVX2(uint8* dst, const uint8* src, size_t count, uint32 alphaMask)
+    {
+        const __m256i vAlpha = _mm256_set1_epi32(static_cast<int>(alphaMask));
+        const __m256i zero = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for(; i + 8 <= count; i += 8) {
+            __m256i* d = reinterpret_cast<__m256i*>(dst + i * 4);
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            const __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(s, vAlpha), zero);
+            _mm256_storeu_si256(d, _mm256_blendv_epi8(s, _mm256_loadu_si256(d), transparent));
+        }
+        blitSSE2(dst + i * 4, src + i * 4, count - i, alphaMask);
+    }
+
+    IMAGE_AVX2_TARGET bool hasOpaqueAVX2(const uint8* pixels, __m256i vAlpha)
+    {
+        const __m256i alpha = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels)), vAlpha);
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, _mm256_setzero_si256())) != -1;
+    }
+
+    IMAGE_AVX2_TARGET bool opaqueSpanAVX2(const uint8* pixels, size_t count, uint32 alphaMask, size_t& first, size_t& last)
+    {
+        const __m256i vAlpha = _mm256_set1_epi32(static_cast<int>(alphaMask));
+
+        size_t i = 0;
+        while(i + 8 <= count && !hasOpaqueAVX2(pixels + i * 4, vAlpha))
+            i += 8;
+        while(i < count && !isOpaque(pixels + i * 4))
+            ++i;
+        if(i == count)
+            return false;
+        first = i;
+
+        size_t j = count;
+        while(j >= first + 8 && !hasOpaqueAVX2(pixels + (j - 8) * 4, vAlpha))
+            j -= 8;
+        while(!isOpaque(pixels + (j - 1) * 4))
+            --j;
+        last = j - 1;
+        return true;
+    }
+#endif
+
+#if defined(IMAGE_NEON)
+    void replaceNEON(uint8* pixels, size_t count, uint32 match, uint32 equal, uint32 notEqual)
+    {
+        const uint32x4_t vMatch = vdupq_n_u32(match);
+        const uint32x4_t vEqual = vdupq_n_u32(equal);
+        const uint32x4_t vNotEqual = vdupq_n_u32(notEqual);
+
+        size_t i = 0;
+        for(; i + 4 <= count; i += 4) {
+            uint32* p = reinterpret_cast<uint32*>(pixels + i * 4);
+            const uint32x4_t mask = vceqq_u32(vld1q_u32(p), vMatch);
+            vst1q_u32(p, vbslq_u32(mask, vEqual, vNotEqual));
+        }
+        replaceScalar(pixels + i * 4, count - i, match, equal, notEqual);
+    }
+
+    void blitNEON(uint8* dst, const uint8* src, size_t count, uint32 alphaMask)
+    {
+        const uint32x4_t vAlpha = vdupq_n_u32(alphaMask);
+
+        size_t i = 0;
+        for(; i + 4 <= count; i += 4) {
+            uint32* d = reinterpret_cast<uint32*>(dst + i * 4);
+            const uint32x4_t s = vld1q_u32(reinterpret_cast<const uint32*>(src + i * 4));
+            const uint32x4_t opaque = vtstq_u32(s, vAlpha);
+            vst1q_u32(d, vbslq_u32(opaque, s, vld1q_u32(d)));
+        }
+        blitScalar(dst + i * 4, src + i * 4, count - i, alphaMask);
+    }
+
+    bool hasOpaqueNEON(const uint8* pixels, uint32x4_t vAlpha)
+    {
+        const uint32x4_t alpha = vandq_u32(vld1q_u32(reinterpret_cast<const uint32*>(pixels)), vAlpha);
+        const uint32x2_t folded = vorr_u32(vget_low_u32(alpha), vget_high_u32(alpha));
+        return vget_lane_u64(vreinterpret_u64_u32(folded), 0) != 0;
+    }
+
+    bool opaqueSpanNEON(const uint8* pixels, size_t count, uint32 alphaMask, size_t& first, size_t& last)
+    {
+        const uint32x4_t vAlpha = vdupq_n_u32(alphaMask);
+
+        size_t i = 0;
+        while(i + 4 <= count && !hasOpaqueNEON(pixels + i * 4, vAlpha))
+            i += 4;
+        while(i < count && !isOpaque(pixels + i * 4))
+            ++i;
+        if(i == count)
+            return false;
+        first = i;
+
+        size_t j = count;
+        while(j >= first + 4 && !hasOpaqueNEON(pixels + (j - 4) * 4, vAlpha))
+            j -= 4;
+        while(!isOpaque(pixels + (j - 1) * 4))
+            --j;
+        last = j - 1;
+        return true;
+    }
+#endif
+
+    struct PixelKernels
+    {
+        void(*replace)(uint8*, size_t, uint32, uint32, uint32);
+        void(*blit)(uint8*, const uint8*, size_t, uint32);
+        bool(*opaqueSpan)(const uint8*, size_t, uint32, size_t&, size_t&);
+    };
+
+    PixelKernels selectKernels()
+    {
+#if defined(IMAGE_AVX2)
+        if(stdext::cpu_supports_avx2())
+            return { replaceAVX2, blitAVX2, opaqueSpanAVX2 };
+#endif
+#if defined(IMAGE_SSE2)
+        return { replaceSSE2, blitSSE2, opaqueSpanSSE2 };
+#elif defined(IMAGE_NEON)
+        return { replaceNEON, blitNEON, opaqueSpanNEON };
+#else
+        return { replaceScalar, blitScalar, opaqueSpanScalar };
+#endif
+    }
+
+    const PixelKernels& kernels()
+    {
+        static const PixelKernels selected = selectKernels();
+        return selected;
+    }
+
+    const uint32 ALPHA_MASK = toPixel(0, 0, 0, 0xFF);
+}
+
 Image::Image(const Size& size, int bpp, uint8* pixels)
 {
     m_size = size;
@@ -83,40 +366,16 @@ void Image::overwriteMask(const Color& maskedColor, const Color& insideColor, co
 {
     assert(m_bpp == 4);
 
-    for(int p = 0; p < getPixelCount(); ++p) {
-        uint8& r = m_pixels[p * 4 + 0];
-        uint8& g = m_pixels[p * 4 + 1];
-        uint8& b = m_pixels[p * 4 + 2];
-        uint8& a = m_pixels[p * 4 + 3];
-
-        Color pixelColor(r, g, b, a);
-        Color writeColor = (pixelColor == maskedColor) ? insideColor : outsideColor;
-
-        r = writeColor.r();
-        g = writeColor.g();
-        b = writeColor.b();
-        a = writeColor.a();
-    }
+    kernels().replace(getPixelData(), getPixelCount(), toPixel(maskedColor), toPixel(insideColor), toPixel(outsideColor));
 }
 
 void Image::overwrite(const Color& color)
 {
     assert(m_bpp == 4);
 
-    for(int p = 0; p < getPixelCount(); ++p) {
-        uint8& r = m_pixels[p * 4 + 0];
-        uint8& g = m_pixels[p * 4 + 1];
-        uint8& b = m_pixels[p * 4 + 2];
-        uint8& a = m_pixels[p * 4 + 3];
-
-        Color pixelColor(r, g, b, a);
-        Color writeColor = (pixelColor == Color::alpha) ? Color::alpha : color;
-
-        r = writeColor.r();
-        g = writeColor.g();
-        b = writeColor.b();
-        a = writeColor.a();
-    }
+    // fully transparent pixels are kept, everything else takes the color
+    const uint32 transparent = toPixel(Color::alpha);
+    kernels().replace(getPixelData(), getPixelCount(), transparent, transparent, toPixel(color));
 }
 
 void Image::blit(const Point& dest, const ImagePtr& other)
@@ -126,22 +385,9 @@ void Image::blit(const Point& dest, const ImagePtr& other)
     if(!other)
         return;
 
-    int coloredPixelSize = 0;
-
-    uint8* otherPixels = other->getPixelData();
-    for(int p = 0; p < other->getPixelCount(); ++p) {
-        const int x = p % other->getWidth();
-        const int y = p / other->getWidth();
-        const int pos = ((dest.y + y) * m_size.width() + (dest.x + x)) * 4;
-
-        if(otherPixels[p * 4 + 3] != 0) {
-            m_pixels[pos + 0] = otherPixels[p * 4 + 0];
-            m_pixels[pos + 1] = otherPixels[p * 4 + 1];
-            m_pixels[pos + 2] = otherPixels[p * 4 + 2];
-            m_pixels[pos + 3] = otherPixels[p * 4 + 3];
-            ++coloredPixelSize;
-        }
-    }
+    const int width = other->getWidth();
+    for(int y = 0; y < other->getHeight(); ++y)
+        kernels().blit(getPixel(dest.x, dest.y + y), other->getPixel(0, y), width, ALPHA_MASK);
 }
 
 void Image::paste(const ImagePtr& other)
@@ -151,17 +397,33 @@ void Image::paste(const ImagePtr& other)
     if(!other)
         return;
 
-    uint8* otherPixels = other->getPixelData();
-    for(int p = 0; p < other->getPixelCount(); ++p) {
-        const int x = p % other->getWidth();
-        const int y = p / other->getWidth();
-        const int pos = (y * m_size.width() + x) * 4;
+    const int rowSize = other->getWidth() * 4;
+    for(int y = 0; y < other->getHeight(); ++y)
+        memcpy(getPixel(0, y), other->getPixel(0, y), rowSize);
+}
+
+Rect Image::getOpaqueRect(const Rect& area)
+{
+    assert(m_bpp == 4);
+
+    Rect rect;
+    for(int y = area.top(); y <= area.bottom(); ++y) {
+        size_t first, last;
+        if(!kernels().opaqueSpan(getPixel(area.left(), y), area.width(), ALPHA_MASK, first, last))
+            continue;
+
+        const int left = area.left() + static_cast<int>(first);
+        const int right = area.left() + static_cast<int>(last);
+        if(!rect.isValid()) {
+            rect = Rect(Point(left, y), Point(right, y));
+            continue;
+        }
 
-        m_pixels[pos + 0] = otherPixels[p * 4 + 0];
-        m_pixels[pos + 1] = otherPixels[p * 4 + 1];
-        m_pixels[pos + 2] = otherPixels[p * 4 + 2];
-        m_pixels[pos + 3] = otherPixels[p * 4 + 3];
+        rect.setLeft(std::min<int>(left, rect.left()));
+        rect.setRight(std::max<int>(right, rect.right()));
+        rect.setBottom(y);
     }
+    return rect;
 }
 
 bool Image::nextMipmap()
@@ -181,8 +443,9 @@ bool Image::nextMipmap()
 
     //FIXME: calculate mipmaps for 8x1, 4x1, 2x1 ...
     if(iw != 1 && ih != 1) {
-        for(int x = 0; x < ow; ++x) {
-            for(int y = 0; y < oh; ++y) {
+        // walk rows first so both input rows are read sequentially
+        for(int y = 0; y < oh; ++y) {
+            for(int x = 0; x < ow; ++x) {
                 uint8* inPixel[4];
                 inPixel[0] = &m_pixels[((y * 2) * iw + (x * 2)) * 4];
                 inPixel[1] = &m_pixels[((y * 2) * iw + (x * 2) + 1) * 4];
@@ -40,6 +40,8 @@ public:
     void overwrite(const Color& color);
     void blit(const Point& dest, const ImagePtr& other);
     void paste(const ImagePtr& other);
+    // smallest rect inside area holding every pixel that is not fully transparent, invalid if none
+    Rect getOpaqueRect(const Rect& area);
     void resize(const Size& size) { m_size = size; m_pixels.resize(size.area() * m_bpp, 0); }
     bool nextMipmap();
 
@@ -75,6 +75,10 @@ void Texture::uploadPixels(const ImagePtr& image, bool buildMipmaps, bool compre
     if(!setupSize(image->getSize(), buildMipmaps))
         return;
 
+    // textures created empty get their gl object on the first upload
+    if(m_id == 0)
+        createTexture();
+
     ImagePtr glImage = image;
     if(m_size != m_glSize) {
         glImage = ImagePtr(new Image(m_glSize, image->getBpp()));
@@ -26,6 +26,7 @@
 #include "image.h"
 
 #include <framework/core/resourcemanager.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/graphics/apngloader.h>
@@ -45,6 +46,8 @@ void TextureManager::terminate()
         m_liveReloadEvent->cancel();
         m_liveReloadEvent = nullptr;
     }
+    // workers are already stopped, whatever is still decoding is dropped
+    cancelDecodes();
     m_textures.clear();
     m_animatedTextures.clear();
     m_emptyTexture = nullptr;
@@ -52,6 +55,15 @@ void TextureManager::terminate()
 
 void TextureManager::poll()
 {
+    for(auto it = m_pendingTextures.begin(); it != m_pendingTextures.end();) {
+        if(it->second.decoded.is_ready()) {
+            finishTexture(it->first, it->second);
+            it = m_pendingTextures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
     // update only every 16msec, this allows upto 60 fps for animated textures
     static ticks_t lastUpdate = 0;
     const ticks_t now = g_clock.millis();
@@ -65,18 +77,30 @@ void TextureManager::poll()
 
 void TextureManager::clearCache()
 {
+    cancelDecodes();
     m_animatedTextures.clear();
     m_textures.clear();
 }
 
+void TextureManager::cancelDecodes()
+{
+    // decodes already queued return right away instead of uploading into dropped textures
+    m_decodesCancelled->store(true);
+    m_decodesCancelled = std::make_shared<std::atomic<bool>>(false);
+    m_pendingTextures.clear();
+}
+
 void TextureManager::liveReload()
 {
     if(m_liveReloadEvent)
         return;
     m_liveReloadEvent = g_dispatcher.cycleEvent([this] {
-        for(auto& it : m_textures) {
-            const std::string& path = g_resources.guessFilePath(it.first, "png");
-            const TexturePtr& tex = it.second;
+        for(ResourceId id = 0; id < m_textures.size(); ++id) {
+            const TexturePtr& tex = m_textures[id];
+            if(!tex || m_pendingTextures.find(id) != m_pendingTextures.end())
+                continue;
+
+            const std::string& path = g_resources.guessFilePath(g_resources.getResourcePath(id), "png");
             if(tex->getTime() >= g_resources.getFileTime(path))
                 continue;
 
@@ -89,69 +113,131 @@ void TextureManager::liveReload()
     }, 1000);
 }
 
-TexturePtr TextureManager::getTexture(const std::string& fileName)
+void TextureManager::preloadAll(const std::vector<std::string>& fileNames)
 {
-    TexturePtr texture;
+    for(const std::string& fileName : fileNames)
+        getTexture(fileName, true);
+}
 
+TexturePtr TextureManager::getTexture(const std::string& fileName, bool async)
+{
     // before must resolve filename to full path
-    const std::string filePath = g_resources.resolvePath(fileName);
+    return getTexture(g_resources.getResourceId(fileName), async);
+}
+
+TexturePtr TextureManager::getTexture(ResourceId id, bool async)
+{
+    if(id >= m_textures.size())
+        m_textures.resize(id + 1);
 
     // check if the texture is already loaded
-    const auto it = m_textures.find(filePath);
-    if(it != m_textures.end()) {
-        texture = it->second;
+    const TexturePtr& cached = m_textures[id];
+    if(cached) {
+        // still decoding, a synchronous caller waits for the worker instead of getting an empty texture
+        if(!async) {
+            const auto it = m_pendingTextures.find(id);
+            if(it != m_pendingTextures.end()) {
+                const PendingTexture pending = it->second;
+                m_pendingTextures.erase(it);
+                finishTexture(id, pending);
+            }
+        }
+        return cached;
     }
 
-    // texture not found, load it
-    if(!texture) {
-        try {
-            const std::string filePathEx = g_resources.guessFilePath(filePath, "png");
-
-            // load texture file data
-            std::stringstream fin;
-            g_resources.readFileStream(filePathEx, fin);
-            texture = loadTexture(fin);
-        } catch(stdext::exception& e) {
-            g_logger.error(stdext::format("Unable to load texture '%s': %s", fileName, e.what()));
-            texture = g_textures.getEmptyTexture();
-        }
+    const std::string& filePath = g_resources.getResourcePath(id);
 
-        if(texture) {
-            texture->setTime(stdext::time());
-            texture->setSmooth(true);
-            m_textures[filePath] = texture;
-        }
+    // texture not found, decode it in the background and hand out an empty texture meanwhile
+    // an animated texture until decoded, apngs then animate in every place that holds it
+    if(async) {
+        const AnimatedTexturePtr texture(new AnimatedTexture);
+        const auto cancelled = m_decodesCancelled;
+        m_textures[id] = texture;
+        m_pendingTextures[id] = { texture, g_asyncDispatcher.schedule([filePath, cancelled] { return decodeTexture(filePath, cancelled); }) };
+        return texture;
+    }
+
+    // or load it right away
+    TexturePtr texture;
+    const DecodedTexturePtr decoded = decodeTexture(filePath);
+    if(!decoded->error.empty()) {
+        g_logger.error(stdext::format("Unable to load texture '%s': %s", filePath, decoded->error));
+        texture = g_textures.getEmptyTexture();
+    } else
+        texture = createTexture(*decoded);
+
+    if(texture) {
+        texture->setTime(stdext::time());
+        texture->setSmooth(true);
+        m_textures[id] = texture;
     }
 
     return texture;
 }
 
-TexturePtr TextureManager::loadTexture(std::stringstream& file)
+TextureManager::DecodedTexturePtr TextureManager::decodeTexture(const std::string& filePath, const std::shared_ptr<std::atomic<bool>>& cancelled)
 {
-    TexturePtr texture;
-
-    apng_data apng;
-    if(load_apng(file, &apng) == 0) {
-        const Size imageSize(apng.width, apng.height);
-        if(apng.num_frames > 1) { // animated texture
-            std::vector<ImagePtr> frames;
-            std::vector<int> framesDelay;
-            for(uint i = 0; i < apng.num_frames; ++i) {
-                uchar* frameData = apng.pdata + ((apng.first_frame + i) * imageSize.area() * apng.bpp);
-                int frameDelay = apng.frames_delay[i];
-
-                framesDelay.push_back(frameDelay);
-                frames.push_back(ImagePtr(new Image(imageSize, apng.bpp, frameData)));
-            }
-            const AnimatedTexturePtr animatedTexture = new AnimatedTexture(imageSize, frames, framesDelay);
-            m_animatedTextures.push_back(animatedTexture);
-            texture = animatedTexture;
-        } else {
-            const auto image = ImagePtr(new Image(imageSize, apng.bpp, apng.pdata));
-            texture = TexturePtr(new Texture(image));
+    // runs on the async dispatcher, must not touch any gl or manager state
+    const auto decoded = std::make_shared<DecodedTexture>();
+    if(cancelled && *cancelled)
+        return decoded;
+
+    try {
+        const std::string filePathEx = g_resources.guessFilePath(filePath, "png");
+
+        // load texture file data
+        std::stringstream fin;
+        g_resources.readFileStream(filePathEx, fin);
+
+        apng_data apng;
+        if(load_apng(fin, &apng) == 0) {
+            const Size imageSize(apng.width, apng.height);
+            if(apng.num_frames > 1) { // animated texture
+                for(uint i = 0; i < apng.num_frames; ++i) {
+                    uchar* frameData = apng.pdata + ((apng.first_frame + i) * imageSize.area() * apng.bpp);
+                    decoded->framesDelay.push_back(apng.frames_delay[i]);
+                    decoded->frames.push_back(ImagePtr(new Image(imageSize, apng.bpp, frameData)));
+                }
+            } else
+                decoded->frames.push_back(ImagePtr(new Image(imageSize, apng.bpp, apng.pdata)));
+            free_apng(&apng);
         }
-        free_apng(&apng);
+    } catch(stdext::exception& e) {
+        decoded->error = e.what();
     }
+    return decoded;
+}
 
-    return texture;
+TexturePtr TextureManager::createTexture(const DecodedTexture& decoded)
+{
+    if(decoded.frames.empty())
+        return nullptr;
+
+    if(decoded.frames.size() > 1) {
+        const AnimatedTexturePtr animatedTexture = new AnimatedTexture(decoded.frames.front()->getSize(), decoded.frames, decoded.framesDelay);
+        m_animatedTextures.push_back(animatedTexture);
+        return animatedTexture;
+    }
+
+    return TexturePtr(new Texture(decoded.frames.front()));
+}
+
+void TextureManager::finishTexture(ResourceId id, const PendingTexture& pending)
+{
+    const DecodedTexturePtr decoded = pending.decoded.get();
+    if(!decoded->error.empty())
+        g_logger.error(stdext::format("Unable to load texture '%s': %s", g_resources.getResourcePath(id), decoded->error));
+
+    // a texture that failed to decode just stays empty
+    if(decoded->frames.empty())
+        return;
+
+    const AnimatedTexturePtr& texture = pending.texture;
+    if(decoded->frames.size() > 1) {
+        texture->setFrames(decoded->frames.front()->getSize(), decoded->frames, decoded->framesDelay);
+        m_animatedTextures.push_back(texture);
+    } else
+        texture->uploadPixels(decoded->frames.front());
+    texture->setTime(stdext::time());
+    texture->setSmooth(true);
 }
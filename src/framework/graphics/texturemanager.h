@@ -25,6 +25,9 @@
 
 #include "texture.h"
 #include <framework/core/declarations.h>
+#include <framework/stdext/thread.h>
+
+#include <atomic>
 
 class TextureManager
 {
@@ -34,16 +37,39 @@ public:
     void poll();
 
     void clearCache();
+    /// Drops the textures still decoding, they stay empty
+    void cancelDecodes();
     void liveReload();
 
-    void preload(const std::string& fileName) { getTexture(fileName); }
-    TexturePtr getTexture(const std::string& fileName);
+    void preload(const std::string& fileName) { getTexture(fileName, true); }
+    void preloadAll(const std::vector<std::string>& fileNames);
+    // async textures are returned empty and filled by a later poll once decoded
+    TexturePtr getTexture(const std::string& fileName, bool async = false);
+    TexturePtr getTexture(ResourceId id, bool async = false);
     const TexturePtr& getEmptyTexture() { return m_emptyTexture; }
 
 private:
-    TexturePtr loadTexture(std::stringstream& file);
+    struct DecodedTexture
+    {
+        std::vector<ImagePtr> frames;
+        std::vector<int> framesDelay;
+        std::string error;
+    };
+    using DecodedTexturePtr = std::shared_ptr<DecodedTexture>;
+
+    struct PendingTexture
+    {
+        AnimatedTexturePtr texture;
+        boost::shared_future<DecodedTexturePtr> decoded;
+    };
+
+    static DecodedTexturePtr decodeTexture(const std::string& filePath, const std::shared_ptr<std::atomic<bool>>& cancelled = nullptr);
+    TexturePtr createTexture(const DecodedTexture& decoded);
+    void finishTexture(ResourceId id, const PendingTexture& pending);
 
-    std::unordered_map<std::string, TexturePtr> m_textures;
+    std::vector<TexturePtr> m_textures; // indexed by resource id
+    std::unordered_map<ResourceId, PendingTexture> m_pendingTextures;
+    std::shared_ptr<std::atomic<bool>> m_decodesCancelled{ std::make_shared<std::atomic<bool>>(false) };
     std::vector<AnimatedTexturePtr> m_animatedTextures;
     TexturePtr m_emptyTexture;
     ScheduledEventPtr m_liveReloadEvent;
@@ -79,6 +79,8 @@ public:
         addVertex(right, top);
     }
 
+    void append(const VertexArray& other) { m_buffer.append(other.m_buffer.data(), other.m_buffer.size()); }
+
     void clear() { m_buffer.reset(); }
     float* vertices() const { return m_buffer.data(); }
     int vertexCount() const { return m_buffer.size() / 2; }
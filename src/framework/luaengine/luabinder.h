@@ -93,18 +93,24 @@ namespace luabinder
         }
     };
 
+    /// Fill missing arguments with nil or drop extra ones
+    inline void adjust_stack_size(LuaInterface* lua, int size)
+    {
+        while(lua->stackSize() != size) {
+            if(lua->stackSize() < size)
+                lua->pushNil();
+            else
+                lua->pop();
+        }
+    }
+
     /// Bind different types of functions generating a lambda
     template<typename Ret, typename F, typename Tuple>
     LuaCppFunction bind_fun_specializer(const F& f)
     {
         enum { N = std::tuple_size<Tuple>::value };
         return [=](LuaInterface* lua) -> int {
-            while(lua->stackSize() != N) {
-                if(lua->stackSize() < N)
-                    g_lua.pushNil();
-                else
-                    g_lua.pop();
-            }
+            adjust_stack_size(lua, N);
             Tuple tuple;
             pack_values_into_tuple<N>::call(tuple, lua);
             return expand_fun_arguments<N, Ret>::call(tuple, f, lua);
@@ -227,6 +233,46 @@ namespace luabinder
             return mf(obj, lua);
         };
     }
+
+    /// Call member functions straight from a lua C function, the member function pointer is its upvalue
+    template<typename Ret, class FC, typename... Args>
+    int call_mem_fun(LuaInterface* lua, Ret(FC::* const& f)(Args...))
+    {
+        using Tuple = std::tuple<stdext::shared_object_ptr<FC>, typename stdext::remove_const_ref<Args>::type...>;
+        enum { N = std::tuple_size<Tuple>::value };
+        adjust_stack_size(lua, N);
+        Tuple tuple;
+        pack_values_into_tuple<N>::call(tuple, lua);
+        const auto mf = [f](const stdext::shared_object_ptr<FC>& obj, const Args&... args) -> Ret {
+            if(!obj)
+                throw LuaException("failed to call a member function because the passed object is nil");
+            return (obj.get()->*f)(args...);
+        };
+        return expand_fun_arguments<N, typename stdext::remove_const_ref<Ret>::type>::call(tuple, mf, lua);
+    }
+
+    /// Call customized member functions straight from a lua C function
+    template<typename C>
+    int call_custom_mem_fun(LuaInterface* lua, int (C::* const& f)(LuaInterface*))
+    {
+        auto obj = lua->castValue<stdext::shared_object_ptr<C>>(1);
+        lua->remove(1);
+        return ((*obj).*f)(lua);
+    }
+
+    /// Push member functions as lua C functions, without a std::function per call
+    template<typename C, typename Ret, class FC, typename... Args>
+    void push_mem_fun(LuaInterface* lua, Ret(FC::* f)(Args...))
+    {
+        lua->pushDirectFunction<Ret(FC::*)(Args...), &call_mem_fun<Ret, FC, Args...>>(f);
+    }
+
+    /// Push customized member functions as lua C functions
+    template<typename C>
+    void push_mem_fun(LuaInterface* lua, int (C::* f)(LuaInterface*))
+    {
+        lua->pushDirectFunction<int (C::*)(LuaInterface*), &call_custom_mem_fun<C>>(f);
+    }
 }
 
 #endif
@@ -30,6 +30,43 @@
 #include <lua.hpp>
 #endif
 
+#ifdef FW_LUA_BYTECODE_CACHE
+#include <framework/core/asyncdispatcher.h>
+
+namespace {
+    // bytecode is only valid for the interpreter build that produced it
+#if defined(LUAJIT_VERSION)
+    const std::string BYTECODE_VERSION = stdext::format("%s/%d", LUAJIT_VERSION, static_cast<int>(sizeof(void*)));
+#else
+    const std::string BYTECODE_VERSION = stdext::format("%s/%d", LUA_RELEASE, static_cast<int>(sizeof(void*)));
+#endif
+    const std::string BYTECODE_DIR = "/bytecode";
+
+    int writeBytecode(lua_State*, const void* data, size_t size, void* userdata)
+    {
+        static_cast<std::string*>(userdata)->append(static_cast<const char*>(data), size);
+        return 0;
+    }
+
+    // cache files written by the async workers, their failures are logged from the main thread
+    std::vector<boost::shared_future<std::string>> pendingBytecodeWrites;
+
+    void checkBytecodeWrites()
+    {
+        auto it = pendingBytecodeWrites.begin();
+        while(it != pendingBytecodeWrites.end()) {
+            if(!it->is_ready()) {
+                ++it;
+                continue;
+            }
+            if(!it->get().empty())
+                g_logger.error(stdext::format("Unable to cache lua bytecode: %s", it->get()));
+            it = pendingBytecodeWrites.erase(it);
+        }
+    }
+}
+#endif
+
 LuaInterface g_lua;
 
 LuaInterface::LuaInterface()
@@ -74,6 +111,9 @@ void LuaInterface::terminate()
 {
     // close lua state, it will release all objects
     closeLuaState();
+#ifdef FW_LUA_BYTECODE_CACHE
+    checkBytecodeWrites();
+#endif
     assert(m_totalFuncRefs == 0);
     assert(m_totalObjRefs == 0);
 }
@@ -332,7 +372,11 @@ void LuaInterface::loadScript(const std::string & fileName)
 
     const std::string buffer = g_resources.readFileContents(filePath);
     const std::string source = "@" + filePath;
+#ifdef FW_LUA_BYTECODE_CACHE
+    loadCachedBuffer(buffer, source);
+#else
     loadBuffer(buffer, source);
+#endif
 }
 
 void LuaInterface::loadFunction(const std::string & buffer, const std::string & source)
@@ -631,6 +675,8 @@ int LuaInterface::luaCppFunctionCallback(lua_State*)
 
     int numRets = 0;
 
+    const ticks_t start = g_lua.m_profiling ? stdext::micros() : 0;
+
     // do the call
     try {
         g_lua.m_cppCallbackDepth++;
@@ -638,17 +684,47 @@ int LuaInterface::luaCppFunctionCallback(lua_State*)
         g_lua.m_cppCallbackDepth--;
         assert(numRets == g_lua.stackSize());
     } catch(stdext::exception& e) {
-        // cleanup stack
-        while(g_lua.stackSize() > 0)
-            g_lua.pop();
-        numRets = 0;
-        g_lua.pushString(stdext::format("C++ call failed: %s", g_lua.traceback(e.what())));
-        g_lua.error();
+        luaCallbackError(e);
     }
 
+    if(start != 0)
+        luaProfileCallback(start);
+
     return numRets;
 }
 
+void LuaInterface::luaProfileCallback(ticks_t start)
+{
+    // hooks don't run while in C++, so a sample is due when the call itself used up the interval
+    if(!g_lua.m_profiling)
+        return;
+
+    const ticks_t now = stdext::micros();
+    const ticks_t lastSample = g_lua.m_profilerLastSample;
+    if(now - lastSample < g_lua.m_profilerInterval)
+        return;
+
+    // level 0 is the C++ function, its caller gets the time before the call
+    const std::string callerStack = g_lua.getProfilerStack(1);
+    lua_Debug ar;
+    lua_getstack(g_lua.L, 0, &ar);
+    lua_getinfo(g_lua.L, "Sn", &ar);
+
+    if(start > lastSample)
+        g_lua.m_profilerStacks[callerStack] += start - lastSample;
+    g_lua.m_profilerStacks[callerStack + ";" + g_lua.getProfilerFrame(ar)] += now - std::max<ticks_t>(start, lastSample);
+    g_lua.m_profilerLastSample = now;
+}
+
+void LuaInterface::luaCallbackError(const stdext::exception& e)
+{
+    // cleanup stack
+    while(g_lua.stackSize() > 0)
+        g_lua.pop();
+    g_lua.pushString(stdext::format("C++ call failed: %s", g_lua.traceback(e.what())));
+    g_lua.error();
+}
+
 int LuaInterface::luaCollectCppFunction(lua_State*)
 {
     auto funcPtr = static_cast<LuaCppFunctionPtr*>(g_lua.popUserdata());
@@ -722,6 +798,144 @@ void LuaInterface::collectGarbage()
 
         collecting = false;
     }
+
+    m_gcCollecting = false;
+    m_gcThreshold = getHeapSize() * 2;
+
+}
+
+void LuaInterface::stepGarbageCollector(int budgetMicros)
+{
+    if(m_gcBudget == 0) {
+        if(m_gcBackstop) {
+            lua_gc(L, LUA_GCSETPAUSE, m_gcDefaultPause);
+            m_gcBackstop = false;
+        }
+        return;
+    }
+
+    // the automatic collector keeps running, but only starts a cycle long after the budgeted steps would
+    if(!m_gcBackstop) {
+        m_gcDefaultPause = lua_gc(L, LUA_GCSETPAUSE, GC_BACKSTOP_PAUSE);
+        m_gcBackstop = true;
+    }
+
+    const ticks_t start = stdext::micros();
+    const int heapSize = getHeapSize();
+
+    // like the automatic collector, a new cycle only starts once the heap doubled since the last one
+    if(m_gcCollecting || heapSize >= m_gcThreshold) {
+        m_gcCollecting = true;
+
+        // far behind the allocations, finish the cycle whatever it costs so the heap can't run away
+        const bool behind = m_gcThreshold > 0 && heapSize >= m_gcThreshold * 2;
+        const ticks_t deadline = start + std::min<int>(budgetMicros, m_gcBudget);
+        do {
+            if(lua_gc(L, LUA_GCSTEP, 0)) {
+                m_gcCollecting = false;
+                m_gcThreshold = getHeapSize() * 2;
+                ++m_gcCycles;
+                break;
+            }
+        } while(behind || stdext::micros() < deadline);
+    }
+
+    const ticks_t now = stdext::micros();
+    m_gcLastMicros = now - start;
+    m_gcMicrosSum += m_gcLastMicros;
+    ++m_gcSteps;
+    if(now - m_gcLastAverage >= 1000000) {
+        m_gcAverageMicros = m_gcMicrosSum / m_gcSteps;
+        m_gcMicrosSum = 0;
+        m_gcSteps = 0;
+        m_gcLastAverage = now;
+    }
+}
+
+int LuaInterface::getHeapSize()
+{
+    return lua_gc(L, LUA_GCCOUNT, 0);
+}
+
+void LuaInterface::startProfiler(int intervalMicros)
+{
+    if(m_profiling)
+        return;
+
+    m_profiling = true;
+    m_profilerInterval = std::max<int>(intervalMicros, 1);
+    m_profilerCallDepth = 0;
+    m_profilerLastSample = stdext::micros();
+    m_profilerStacks.clear();
+    lua_sethook(L, &LuaInterface::luaProfilerHook, LUA_MASKCOUNT, PROFILER_HOOK_COUNT);
+
+#ifdef LUAJIT_VERSION
+    // hooks don't run inside compiled traces, whose time would be charged to whatever runs next
+    luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+#endif
+}
+
+void LuaInterface::stopProfiler()
+{
+    if(!m_profiling)
+        return;
+
+    m_profiling = false;
+    lua_sethook(L, nullptr, 0, 0);
+
+#ifdef LUAJIT_VERSION
+    luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON);
+#endif
+}
+
+bool LuaInterface::saveProfile(const std::string& fileName)
+{
+    std::string contents;
+    for(const auto& it : m_profilerStacks)
+        contents += it.first + " " + std::to_string(it.second) + "\n";
+    return g_resources.writeFileContents(fileName, contents);
+}
+
+void LuaInterface::luaProfilerHook(lua_State*, lua_Debug*)
+{
+    const ticks_t now = stdext::micros();
+    if(now - g_lua.m_profilerLastSample < g_lua.m_profilerInterval)
+        return;
+
+    g_lua.m_profilerStacks[g_lua.getProfilerStack(0)] += now - g_lua.m_profilerLastSample;
+    g_lua.m_profilerLastSample = now;
+}
+
+std::string LuaInterface::getProfilerFrame(lua_Debug& ar)
+{
+    // ';' separates frames in the folded format
+    std::string frame;
+    if(ar.what && strcmp(ar.what, "C") == 0)
+        frame = stdext::format("[C] %s", ar.name ? ar.name : "?");
+    else if(ar.what && strcmp(ar.what, "main") == 0)
+        frame = stdext::format("main %s", ar.short_src);
+    else
+        frame = stdext::format("%s %s:%d", ar.name ? ar.name : "?", ar.short_src, ar.linedefined);
+    std::replace(frame.begin(), frame.end(), ';', ',');
+    return frame;
+}
+
+std::string LuaInterface::getProfilerStack(int level)
+{
+    std::vector<std::string> frames;
+    lua_Debug ar;
+    while(static_cast<int>(frames.size()) < PROFILER_MAX_DEPTH && lua_getstack(L, level++, &ar) == 1) {
+        lua_getinfo(L, "Sn", &ar);
+        frames.push_back(getProfilerFrame(ar));
+    }
+
+    std::string stack;
+    for(auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if(!stack.empty())
+            stack += ';';
+        stack += *it;
+    }
+    return stack;
 }
 
 void LuaInterface::loadBuffer(const std::string & buffer, const std::string & source)
@@ -732,10 +946,80 @@ void LuaInterface::loadBuffer(const std::string & buffer, const std::string & so
         throw LuaException(popString(), 0);
 }
 
+#ifdef FW_LUA_BYTECODE_CACHE
+void LuaInterface::loadCachedBuffer(const std::string& buffer, const std::string& source)
+{
+    checkBytecodeWrites();
+
+    // nowhere to keep the cache until the user write dir is set up
+    if(g_resources.getWriteDir().empty()) {
+        loadBuffer(buffer, source);
+        return;
+    }
+
+    // one file per script, its header tells which source and interpreter it was compiled from
+    const std::string cacheFile = stdext::format("%s/%s.luac", BYTECODE_DIR, stdext::dec_to_hex(stdext::fnv1a_hash(source)));
+    const std::string key = stdext::dec_to_hex(stdext::fnv1a_hash(buffer, stdext::fnv1a_hash(source, stdext::fnv1a_hash(BYTECODE_VERSION)))) + "\n";
+
+    if(g_resources.fileExists(cacheFile)) {
+        try {
+            const std::string cached = g_resources.readFileContents(cacheFile);
+            if(cached.compare(0, key.length(), key) == 0) {
+                if(luaL_loadbuffer(L, cached.data() + key.length(), cached.length() - key.length(), source.c_str()) == 0)
+                    return;
+                pop(); // broken bytecode, compile it again
+            }
+        } catch(stdext::exception&) {
+        }
+    }
+
+    loadBuffer(buffer, source);
+
+    std::string contents = key;
+#if LUA_VERSION_NUM >= 503
+    lua_dump(L, writeBytecode, &contents, 0);
+#else
+    lua_dump(L, writeBytecode, &contents);
+#endif
+
+    if(!g_resources.directoryExists(BYTECODE_DIR))
+        g_resources.makeDir(BYTECODE_DIR);
+    pendingBytecodeWrites.push_back(g_asyncDispatcher.schedule([cacheFile, contents] {
+        std::string error;
+        g_resources.writeFileBuffer(cacheFile, (const uchar*)contents.data(), contents.size(), error);
+        return error;
+    }));
+}
+#endif
+
 int LuaInterface::pcall(int numArgs, int numRets, int errorFuncIndex)
 {
     assert(hasIndex(-numArgs - 1));
-    return lua_pcall(L, numArgs, numRets, errorFuncIndex);
+    if(!m_profiling)
+        return lua_pcall(L, numArgs, numRets, errorFuncIndex);
+
+    // time spent outside lua is not sampled, so counting starts when lua is entered from the application
+    const bool outermost = m_profilerCallDepth++ == 0;
+    std::string rootFrame;
+    if(outermost) {
+        lua_Debug ar;
+        pushValue(-numArgs - 1);
+        lua_getinfo(L, ">S", &ar);
+        ar.name = nullptr;
+        rootFrame = getProfilerFrame(ar);
+        m_profilerLastSample = stdext::micros();
+    }
+
+    const int ret = lua_pcall(L, numArgs, numRets, errorFuncIndex);
+
+    // the stack is gone, the time since the last sample goes to the called function
+    if(outermost && m_profiling) {
+        const ticks_t now = stdext::micros();
+        m_profilerStacks[rootFrame] += now - m_profilerLastSample;
+        m_profilerLastSample = now;
+    }
+    --m_profilerCallDepth;
+    return ret;
 }
 
 void LuaInterface::call(int numArgs, int numRets)
@@ -1106,6 +1390,15 @@ void LuaInterface::pushThread()
 
 void LuaInterface::pushObject(const LuaObjectPtr & obj)
 {
+    // reuse the object's userdata while lua still holds it,
+    // the weak ref id may have been taken by another value meanwhile
+    if(obj->m_userdataRef != -1) {
+        getWeakRef(obj->m_userdataRef);
+        if(isUserdata() && static_cast<LuaObjectPtr*>(toUserdata())->get() == obj.get())
+            return;
+        pop();
+    }
+
     // fills a new userdata with a new LuaObjectPtr pointer
     new(newUserdata(sizeof(LuaObjectPtr))) LuaObjectPtr(obj);
     m_totalObjRefs++;
@@ -1114,6 +1407,9 @@ void LuaInterface::pushObject(const LuaObjectPtr & obj)
     if(isNil())
         g_logger.fatal(stdext::format("metatable for class '%s' not found, did you bind the C++ class?", obj->getClassName()));
     setMetatable();
+
+    pushValue();
+    obj->m_userdataRef = weakRef();
 }
 
 void LuaInterface::pushCFunction(LuaCFunction func, int n)
@@ -26,11 +26,21 @@
 #include "declarations.h"
 
 struct lua_State;
+struct lua_Debug;
 using LuaCFunction = int (*)(lua_State*);
 
 /// Class that manages LUA stuff
 class LuaInterface
 {
+    enum {
+        // instructions between profiler hook calls
+        PROFILER_HOOK_COUNT = 1000,
+        PROFILER_MAX_DEPTH = 64,
+        // automatic collector pause (heap growth in %) while collection is budgeted, only reached
+        // when lua allocates a lot within a single frame
+        GC_BACKSTOP_PAUSE = 400
+    };
+
 public:
     LuaInterface();
     ~LuaInterface();
@@ -216,8 +226,21 @@ private:
     static int luaErrorHandler(lua_State* L);
     /// Handle bound cpp functions callbacks
     static int luaCppFunctionCallback(lua_State* L);
+    /// Handle bound direct functions callbacks
+    template<typename T, int(*Call)(LuaInterface*, const T&)>
+    static int luaDirectFunctionCallback(lua_State* L);
+    /// Raise a lua error for an exception thrown by a callback
+    static void luaCallbackError(const stdext::exception& e);
     /// Collect bound cpp function pointers
     static int luaCollectCppFunction(lua_State* L);
+    /// Charges a C++ callback that started at start to a [C] frame, when the interval elapsed
+    static void luaProfileCallback(ticks_t start);
+    /// Takes a profiler sample every few hundred instructions, when the interval elapsed
+    static void luaProfilerHook(lua_State* L, lua_Debug* ar);
+
+    std::string getProfilerFrame(lua_Debug& ar);
+    /// Frames from the outermost function down to the given stack level, separated by ';'
+    std::string getProfilerStack(int level);
 
 public:
     void createLuaState();
@@ -225,7 +248,30 @@ public:
 
     void collectGarbage();
 
+    /// Runs incremental collection for about budgetMicros (at least one step), between frames,
+    /// the automatic collector is held back to a large pause and only kicks in as a backstop
+    void stepGarbageCollector(int budgetMicros);
+    /// Upper bound of the time spent per step call, 0 gives collection back to the automatic collector
+    void setGarbageCollectorBudget(int micros) { m_gcBudget = std::max<int>(micros, 0); }
+    int getGarbageCollectorBudget() { return m_gcBudget; }
+    int getGarbageCollectorMicros() { return m_gcLastMicros; }
+    int getGarbageCollectorAverageMicros() { return m_gcAverageMicros; }
+    int getGarbageCollectorCycles() { return m_gcCycles; }
+    /// Memory in use by lua, in KB
+    int getHeapSize();
+
+    /// Samples the lua call stack every intervalMicros of time spent in lua, including bound C++ calls
+    void startProfiler(int intervalMicros);
+    void stopProfiler();
+    bool isProfiling() { return m_profiling; }
+    /// Writes the collected samples in folded stack format ("frame;frame;frame micros" lines), as used by flame graph tools
+    bool saveProfile(const std::string& fileName);
+
     void loadBuffer(const std::string& buffer, const std::string& source);
+#ifdef FW_LUA_BYTECODE_CACHE
+    /// Like loadBuffer, but reuses the bytecode compiled by a previous run when the source is unchanged
+    void loadCachedBuffer(const std::string& buffer, const std::string& source);
+#endif
 
     int pcall(int numArgs = 0, int numRets = 0, int errorFuncIndex = 0);
     void call(int numArgs = 0, int numRets = 0);
@@ -302,6 +348,10 @@ public:
     void pushObject(const LuaObjectPtr& obj);
     void pushCFunction(LuaCFunction func, int n = 0);
     void pushCppFunction(const LuaCppFunction& func);
+    /// Pushes a C function that calls Call with a copy of data stored in its upvalue,
+    /// unlike cpp functions there is no heap allocated std::function in between
+    template<typename T, int(*Call)(LuaInterface*, const T&)>
+    void pushDirectFunction(const T& data);
 
     bool isNil(int index = -1);
     bool isBoolean(int index = -1);
@@ -349,6 +399,24 @@ private:
     int m_totalObjRefs;
     int m_totalFuncRefs;
     int m_globalEnv;
+
+    int m_gcBudget{ 1000 };
+    bool m_gcBackstop{ false };
+    int m_gcDefaultPause{ 0 };
+    bool m_gcCollecting{ false };
+    int m_gcThreshold{ 0 };
+    int m_gcCycles{ 0 };
+    int m_gcLastMicros{ 0 };
+    int m_gcAverageMicros{ 0 };
+    ticks_t m_gcMicrosSum{ 0 };
+    int m_gcSteps{ 0 };
+    ticks_t m_gcLastAverage{ 0 };
+
+    bool m_profiling{ false };
+    int m_profilerInterval{ 1000 };
+    int m_profilerCallDepth{ 0 };
+    ticks_t m_profilerLastSample{ 0 };
+    std::unordered_map<std::string, ticks_t> m_profilerStacks;
 };
 
 extern LuaInterface g_lua;
@@ -393,12 +461,15 @@ void LuaInterface::bindClassStaticFunction(const std::string& className, const s
 template<class C, typename F, class FC>
 void LuaInterface::bindClassMemberFunction(const std::string& functionName, F FC::* function)
 {
-    registerClassMemberFunction<C>(functionName, luabinder::bind_mem_fun<C>(function));
+    bindClassMemberFunction<C>(stdext::demangle_class<C>(), functionName, function);
 }
 template<class C, typename F, class FC>
 void LuaInterface::bindClassMemberFunction(const std::string& className, const std::string& functionName, F FC::* function)
 {
-    registerClassMemberFunction(className, functionName, luabinder::bind_mem_fun<C>(function));
+    getGlobal(className);
+    luabinder::push_mem_fun<C>(this, function);
+    setField(functionName);
+    pop();
 }
 
 template<class C, typename F1, typename F2, class FC>
@@ -482,4 +553,40 @@ R LuaInterface::callGlobalField(const std::string& global, const std::string& fi
     return result;
 }
 
+template<typename T, int(*Call)(LuaInterface*, const T&)>
+void LuaInterface::pushDirectFunction(const T& data)
+{
+    // the userdata has no __gc, so it can only hold plain data such as function pointers
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value, "direct function data must be trivial");
+    new(newUserdata(sizeof(T))) T(data);
+    pushCFunction(&LuaInterface::luaDirectFunctionCallback<T, Call>, 1);
+}
+
+template<typename T, int(*Call)(LuaInterface*, const T&)>
+int LuaInterface::luaDirectFunctionCallback(lua_State*)
+{
+    // retrieves the data from userdata
+    const auto data = static_cast<const T*>(g_lua.popUpvalueUserdata());
+    assert(data);
+
+    int numRets = 0;
+
+    const ticks_t start = g_lua.m_profiling ? stdext::micros() : 0;
+
+    // do the call
+    try {
+        g_lua.m_cppCallbackDepth++;
+        numRets = Call(&g_lua, *data);
+        g_lua.m_cppCallbackDepth--;
+        assert(numRets == g_lua.stackSize());
+    } catch(stdext::exception& e) {
+        luaCallbackError(e);
+    }
+
+    if(start != 0)
+        luaProfileCallback(start);
+
+    return numRets;
+}
+
 #endif
@@ -111,10 +111,16 @@ int LuaObject::getUseCount()
 
 std::string LuaObject::getClassName()
 {
-    // TODO: this could be cached for more performance
+    // demangling is slow, so names are cached per type
+    static std::unordered_map<const std::type_info*, std::string> classNameMap;
+    const auto& tinfo = typeid(*this);
+    auto it = classNameMap.find(&tinfo);
+    if(it == classNameMap.end()) {
 #ifdef _MSC_VER
-    return stdext::demangle_name(typeid(*this).name()) + 6;
+        it = classNameMap.emplace(&tinfo, stdext::demangle_name(tinfo.name()) + 6).first;
 #else
-    return stdext::demangle_name(typeid(*this).name());
+        it = classNameMap.emplace(&tinfo, stdext::demangle_name(tinfo.name())).first;
 #endif
+    }
+    return it->second;
 }
@@ -86,6 +86,9 @@ public:
 
 private:
     int m_fieldsTableRef{ -1 };
+    int m_userdataRef{ -1 };
+
+    friend class LuaInterface;
 };
 
 template<typename F>
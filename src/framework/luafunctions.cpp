@@ -199,10 +199,14 @@ void Application::registerLuaFunctions()
     // Config
     g_lua.registerClass<Config>();
     g_lua.bindClassMemberFunction<Config>("save", &Config::save);
+    g_lua.bindClassMemberFunction<Config>("saveNow", &Config::saveNow);
     g_lua.bindClassMemberFunction<Config>("setValue", &Config::setValue);
     g_lua.bindClassMemberFunction<Config>("setList", &Config::setList);
     g_lua.bindClassMemberFunction<Config>("getValue", &Config::getValue);
     g_lua.bindClassMemberFunction<Config>("getList", &Config::getList);
+    g_lua.bindClassMemberFunction<Config>("getInteger", &Config::getInteger);
+    g_lua.bindClassMemberFunction<Config>("getNumber", &Config::getNumber);
+    g_lua.bindClassMemberFunction<Config>("getBoolean", &Config::getBoolean);
     g_lua.bindClassMemberFunction<Config>("exists", &Config::exists);
     g_lua.bindClassMemberFunction<Config>("remove", &Config::remove);
     g_lua.bindClassMemberFunction<Config>("setNode", &Config::setNode);
@@ -254,6 +258,16 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_app", "getBackgroundPaneFps", &GraphicalApplication::getBackgroundPaneFps, &g_app);
     g_lua.bindSingletonFunction("g_app", "getForegroundPaneMaxFps", &GraphicalApplication::getForegroundPaneMaxFps, &g_app);
     g_lua.bindSingletonFunction("g_app", "getBackgroundPaneMaxFps", &GraphicalApplication::getBackgroundPaneMaxFps, &g_app);
+    g_lua.bindSingletonFunction("g_app", "setLuaGcBudget", &LuaInterface::setGarbageCollectorBudget, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "getLuaGcBudget", &LuaInterface::getGarbageCollectorBudget, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "getLuaGcMicros", &LuaInterface::getGarbageCollectorMicros, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "getLuaGcAverageMicros", &LuaInterface::getGarbageCollectorAverageMicros, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "getLuaGcCycles", &LuaInterface::getGarbageCollectorCycles, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "getLuaHeapSize", &LuaInterface::getHeapSize, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "startLuaProfiler", &LuaInterface::startProfiler, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "stopLuaProfiler", &LuaInterface::stopProfiler, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "isLuaProfiling", &LuaInterface::isProfiling, &g_lua);
+    g_lua.bindSingletonFunction("g_app", "saveLuaProfile", &LuaInterface::saveProfile, &g_lua);
 
     // PlatformWindow
     g_lua.registerSingletonClass("g_window");
@@ -321,6 +335,7 @@ void Application::registerLuaFunctions()
     // Textures
     g_lua.registerSingletonClass("g_textures");
     g_lua.bindSingletonFunction("g_textures", "preload", &TextureManager::preload, &g_textures);
+    g_lua.bindSingletonFunction("g_textures", "preloadAll", &TextureManager::preloadAll, &g_textures);
     g_lua.bindSingletonFunction("g_textures", "clearCache", &TextureManager::clearCache, &g_textures);
     g_lua.bindSingletonFunction("g_textures", "liveReload", &TextureManager::liveReload, &g_textures);
 
@@ -753,6 +768,42 @@ void Application::registerLuaFunctions()
     g_lua.registerClass<UIParticles, UIWidget>();
     g_lua.bindClassStaticFunction<UIParticles>("create", [] { return UIParticlesPtr(new UIParticles); });
     g_lua.bindClassMemberFunction<UIParticles>("addEffect", &UIParticles::addEffect);
+
+    // UIVirtualList
+    g_lua.registerClass<UIVirtualList, UIWidget>();
+    g_lua.bindClassStaticFunction<UIVirtualList>("create", [] { return UIVirtualListPtr(new UIVirtualList); });
+    g_lua.bindClassMemberFunction<UIVirtualList>("addItem", &UIVirtualList::addItem);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setItems", &UIVirtualList::setItems);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setItemText", &UIVirtualList::setItemText);
+    g_lua.bindClassMemberFunction<UIVirtualList>("clearItems", &UIVirtualList::clearItems);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getItemText", &UIVirtualList::getItemText);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setItemCount", &UIVirtualList::setItemCount);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setItemHeight", &UIVirtualList::setItemHeight);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setRowStyle", &UIVirtualList::setRowStyle);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setRowHeight", &UIVirtualList::setRowHeight);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setOverscan", &UIVirtualList::setOverscan);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setMaxItems", &UIVirtualList::setMaxItems);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setScrollStep", &UIVirtualList::setScrollStep);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setAutoScroll", &UIVirtualList::setAutoScroll);
+    g_lua.bindClassMemberFunction<UIVirtualList>("setScrollOffset", &UIVirtualList::setScrollOffset);
+    g_lua.bindClassMemberFunction<UIVirtualList>("scrollToItem", &UIVirtualList::scrollToItem);
+    g_lua.bindClassMemberFunction<UIVirtualList>("scrollToBottom", &UIVirtualList::scrollToBottom);
+    g_lua.bindClassMemberFunction<UIVirtualList>("refresh", &UIVirtualList::refresh);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getItemCount", &UIVirtualList::getItemCount);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getItemHeight", &UIVirtualList::getItemHeight);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getItemOffset", &UIVirtualList::getItemOffset);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getItemAt", &UIVirtualList::getItemAt);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getRowStyle", &UIVirtualList::getRowStyle);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getRowHeight", &UIVirtualList::getRowHeight);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getOverscan", &UIVirtualList::getOverscan);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getMaxItems", &UIVirtualList::getMaxItems);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getScrollStep", &UIVirtualList::getScrollStep);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getScrollOffset", &UIVirtualList::getScrollOffset);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getMaxScrollOffset", &UIVirtualList::getMaxScrollOffset);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getContentHeight", &UIVirtualList::getContentHeight);
+    g_lua.bindClassMemberFunction<UIVirtualList>("getRowWidget", &UIVirtualList::getRowWidget);
+    g_lua.bindClassMemberFunction<UIVirtualList>("isAutoScroll", &UIVirtualList::isAutoScroll);
+    g_lua.bindClassMemberFunction<UIVirtualList>("isScrolledToBottom", &UIVirtualList::isScrolledToBottom);
 #endif
 
 #ifdef FW_NET
@@ -843,6 +894,15 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_sounds", "disableAudio", &SoundManager::disableAudio, &g_sounds);
     g_lua.bindSingletonFunction("g_sounds", "setAudioEnabled", &SoundManager::setAudioEnabled, &g_sounds);
     g_lua.bindSingletonFunction("g_sounds", "isAudioEnabled", &SoundManager::isAudioEnabled, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "setCacheBudget", &SoundManager::setCacheBudget, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getCacheBudget", &SoundManager::getCacheBudget, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getCacheSize", &SoundManager::getCacheSize, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getCacheHitRate", &SoundManager::getCacheHitRate, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "setMaxVoices", &SoundManager::setMaxVoices, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getMaxVoices", &SoundManager::getMaxVoices, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getActiveVoices", &SoundManager::getActiveVoices, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getStolenVoices", &SoundManager::getStolenVoices, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getRejectedVoices", &SoundManager::getRejectedVoices, &g_sounds);
 
     g_lua.registerClass<SoundSource>();
     g_lua.registerClass<CombinedSoundSource, SoundSource>();
@@ -859,6 +919,8 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<SoundChannel>("setEnabled", &SoundChannel::setEnabled);
     g_lua.bindClassMemberFunction<SoundChannel>("isEnabled", &SoundChannel::isEnabled);
     g_lua.bindClassMemberFunction<SoundChannel>("getId", &SoundChannel::getId);
+    g_lua.bindClassMemberFunction<SoundChannel>("setPriority", &SoundChannel::setPriority);
+    g_lua.bindClassMemberFunction<SoundChannel>("getPriority", &SoundChannel::getPriority);
 #endif
 
 #ifdef FW_SQL
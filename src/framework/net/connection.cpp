@@ -21,10 +21,15 @@
  */
 
 #include "connection.h"
+#include "xtea.h"
 
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
 
+#ifdef FW_NET_THREAD
+#include "networkthread.h"
+#endif
+
 #include <boost/asio.hpp>
 #include <memory>
 #include <utility>
@@ -48,23 +53,52 @@ Connection::~Connection()
 #ifndef NDEBUG
     assert(!g_app.isTerminated());
 #endif
-    close();
+    internal_close();
+}
+
+void Connection::init()
+{
+    // a broken vectorized xtea would otherwise only show up as disconnects
+    xtea::selfCheck();
+
+#ifdef FW_NET_THREAD
+    g_network.init();
+#endif
 }
 
 void Connection::poll()
 {
+#ifdef FW_NET_THREAD
+    // the io service runs in the network thread, just consume what it produced
+    g_network.poll();
+#else
     // reset must always be called prior to poll
     g_ioService.reset();
     g_ioService.poll();
+#endif
 }
 
 void Connection::terminate()
 {
+#ifdef FW_NET_THREAD
+    g_network.terminate();
+#endif
     g_ioService.stop();
     m_outputStreams.clear();
 }
 
 void Connection::close()
+{
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asConnection()] { capture0->internal_close(); });
+        return;
+    }
+#endif
+    internal_close();
+}
+
+void Connection::internal_close()
 {
     if(!m_connected && !m_connecting)
         return;
@@ -75,6 +109,12 @@ void Connection::close()
 
     m_connecting = false;
     m_connected = false;
+
+#ifdef FW_NET_THREAD
+    // callbacks may hold the last reference of lua objects, release them in the main thread
+    if(g_network.isCurrentThread())
+        g_network.dispatch([connectCallback = m_connectCallback, errorCallback = m_errorCallback, recvCallback = m_recvCallback] {});
+#endif
     m_connectCallback = nullptr;
     m_errorCallback = nullptr;
     m_recvCallback = nullptr;
@@ -93,6 +133,14 @@ void Connection::close()
 
 void Connection::connect(const std::string& host, uint16 port, const std::function<void()>& connectCallback)
 {
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        m_connecting = true;
+        g_network.post([capture0 = asConnection(), host, port, connectCallback] { capture0->connect(host, port, connectCallback); });
+        return;
+    }
+#endif
+
     m_connected = false;
     m_connecting = true;
     m_error.clear();
@@ -133,6 +181,13 @@ void Connection::write(uint8* buffer, size_t size)
     if(!m_connected)
         return;
 
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.write(asConnection(), buffer, size);
+        return;
+    }
+#endif
+
     // we can't send the data right away, otherwise we could create tcp congestion
     if(!m_outputStream) {
         if(!m_outputStreams.empty()) {
@@ -182,6 +237,13 @@ void Connection::read(uint16 bytes, const RecvCallback& callback)
     if(!m_connected)
         return;
 
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asConnection(), bytes, callback] { capture0->read(bytes, callback); });
+        return;
+    }
+#endif
+
     m_recvCallback = callback;
 
     async_read(m_socket,
@@ -204,6 +266,13 @@ void Connection::read_until(const std::string& what, const RecvCallback& callbac
     if(!m_connected)
         return;
 
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asConnection(), what, callback] { capture0->read_until(what, callback); });
+        return;
+    }
+#endif
+
     m_recvCallback = callback;
 
     async_read_until(m_socket,
@@ -227,6 +296,13 @@ void Connection::read_some(const RecvCallback& callback)
     if(!m_connected)
         return;
 
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asConnection(), callback] { capture0->read_some(callback); });
+        return;
+    }
+#endif
+
     m_recvCallback = callback;
 
     m_socket.async_read_some(buffer(m_inputStream.prepare(RECV_BUFFER_SIZE)),
@@ -243,6 +319,35 @@ void Connection::read_some(const RecvCallback& callback)
     });
 }
 
+void Connection::read_some(uint8* buffer, uint16 size, const RecvCallback& callback)
+{
+    if(!m_connected)
+        return;
+
+#ifdef FW_NET_THREAD
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asConnection(), buffer, size, callback] { capture0->read_some(buffer, size, callback); });
+        return;
+    }
+#endif
+
+    m_recvCallback = callback;
+
+    // reads directly into the caller buffer, it must stay valid until the callback
+    m_socket.async_read_some(asio::buffer(buffer, size),
+                             [capture0 = asConnection(), buffer](auto&& PH1, auto&& PH2)
+    {
+        capture0->onRecvSome(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2), buffer);
+    });
+
+    m_readTimer.cancel();
+    m_readTimer.expires_from_now(boost::posix_time::seconds(static_cast<uint32>(READ_TIMEOUT)));
+    m_readTimer.async_wait([capture0 = asConnection()](auto&& PH1)
+    {
+        capture0->onTimeout(std::forward<decltype(PH1)>(PH1));
+    });
+}
+
 void Connection::onResolve(const boost::system::error_code& error, asio::ip::basic_resolver<asio::ip::tcp>::iterator endpointIterator)
 {
     m_readTimer.cancel();
@@ -259,7 +364,9 @@ void Connection::onResolve(const boost::system::error_code& error, asio::ip::bas
 void Connection::onConnect(const boost::system::error_code& error)
 {
     m_readTimer.cancel();
+#ifndef FW_NET_THREAD
     m_activityTimer.restart();
+#endif
 
     if(error == asio::error::operation_aborted)
         return;
@@ -271,8 +378,17 @@ void Connection::onConnect(const boost::system::error_code& error)
         const asio::ip::tcp::no_delay option(true);
         m_socket.set_option(option);
 
+#ifdef FW_NET_THREAD
+        if(m_connectCallback) {
+            g_network.dispatch([capture0 = asConnection(), connectCallback = m_connectCallback] {
+                capture0->m_activityTimer.restart();
+                connectCallback();
+            });
+        }
+#else
         if(m_connectCallback)
             m_connectCallback();
+#endif
     } else
         handleError(error);
 
@@ -309,7 +425,10 @@ void Connection::onWrite(const boost::system::error_code& error, size_t, const s
 void Connection::onRecv(const boost::system::error_code& error, size_t recvSize)
 {
     m_readTimer.cancel();
+#ifndef FW_NET_THREAD
+    // with the network thread the timer is restarted once the message reaches the main thread
     m_activityTimer.restart();
+#endif
 
     if(error == asio::error::operation_aborted)
         return;
@@ -328,6 +447,25 @@ void Connection::onRecv(const boost::system::error_code& error, size_t recvSize)
         m_inputStream.consume(recvSize);
 }
 
+void Connection::onRecvSome(const boost::system::error_code& error, size_t recvSize, uint8* buffer)
+{
+    m_readTimer.cancel();
+#ifndef FW_NET_THREAD
+    m_activityTimer.restart();
+#endif
+
+    if(error == asio::error::operation_aborted)
+        return;
+
+    if(m_connected) {
+        if(!error) {
+            if(m_recvCallback)
+                m_recvCallback(buffer, recvSize);
+        } else
+            handleError(error);
+    }
+}
+
 void Connection::onTimeout(const boost::system::error_code& error)
 {
     if(error == asio::error::operation_aborted)
@@ -342,8 +480,13 @@ void Connection::handleError(const boost::system::error_code& error)
         return;
 
     m_error = error;
+#ifdef FW_NET_THREAD
+    if(m_errorCallback)
+        g_network.dispatch([errorCallback = m_errorCallback, error] { errorCallback(error); });
+#else
     if(m_errorCallback)
         m_errorCallback(error);
+#endif
     if(m_connected || m_connecting)
         close();
 }
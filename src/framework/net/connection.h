@@ -30,6 +30,8 @@
 
 #include "framework/stdext/time.h"
 
+#include <atomic>
+
 class Connection : public LuaObject
 {
     using ErrorCallback = std::function<void(const boost::system::error_code&)>;
@@ -46,6 +48,7 @@ public:
     Connection();
     ~Connection() override;
 
+    static void init();
     static void poll();
     static void terminate();
 
@@ -56,6 +59,7 @@ public:
     void read(uint16 bytes, const RecvCallback& callback);
     void read_until(const std::string& what, const RecvCallback& callback);
     void read_some(const RecvCallback& callback);
+    void read_some(uint8* buffer, uint16 size, const RecvCallback& callback);
 
     void setErrorCallback(const ErrorCallback& errorCallback) { m_errorCallback = errorCallback; }
 
@@ -69,6 +73,7 @@ public:
 
 protected:
     void internal_connect(const asio::ip::basic_resolver<asio::ip::tcp>::iterator& endpointIterator);
+    void internal_close();
     void internal_write();
     void onResolve(const boost::system::error_code& error, asio::ip::tcp::resolver::iterator endpointIterator);
     void onConnect(const boost::system::error_code& error);
@@ -76,6 +81,7 @@ protected:
     void onWrite(const boost::system::error_code& error, size_t writeSize, const std::shared_ptr<asio::streambuf>&
                  outputStream);
     void onRecv(const boost::system::error_code& error, size_t recvSize);
+    void onRecvSome(const boost::system::error_code& error, size_t recvSize, uint8* buffer);
     void onTimeout(const boost::system::error_code& error);
     void handleError(const boost::system::error_code& error);
 
@@ -92,12 +98,13 @@ protected:
     static std::list<std::shared_ptr<asio::streambuf>> m_outputStreams;
     std::shared_ptr<asio::streambuf> m_outputStream;
     asio::streambuf m_inputStream;
-    bool m_connected;
-    bool m_connecting;
+    std::atomic<bool> m_connected;
+    std::atomic<bool> m_connecting;
     boost::system::error_code m_error;
     stdext::timer m_activityTimer;
 
     friend class Server;
+    friend class NetworkThread;
 };
 
 #endif
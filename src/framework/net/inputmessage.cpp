@@ -32,6 +32,7 @@ InputMessage::InputMessage()
 
 void InputMessage::reset()
 {
+    m_buffer = m_ownBuffer;
     m_messageSize = 0;
     m_readPos = MAX_HEADER_SIZE;
     m_headerPos = MAX_HEADER_SIZE;
@@ -109,6 +110,16 @@ void InputMessage::fillBuffer(uint8* buffer, uint16 size)
     m_messageSize += size;
 }
 
+void InputMessage::wrapBuffer(uint8* buffer, uint16 size)
+{
+    // parse a complete message straight from the receive buffer instead of copying it,
+    // it must be preceded by the header space and stay valid until the message is parsed
+    checkWrite(m_headerPos + size);
+    m_buffer = buffer - m_headerPos;
+    m_readPos = m_headerPos;
+    m_messageSize = size;
+}
+
 void InputMessage::setHeaderSize(uint16 size)
 {
     assert(MAX_HEADER_SIZE - size >= 0);
@@ -78,6 +78,7 @@ public:
 protected:
     void reset();
     void fillBuffer(uint8* buffer, uint16 size);
+    void wrapBuffer(uint8* buffer, uint16 size);
 
     void setHeaderSize(uint16 size);
     void setMessageSize(uint16 size) { m_messageSize = size; }
@@ -100,7 +101,8 @@ private:
     uint16 m_headerPos;
     uint16 m_readPos;
     uint16 m_messageSize;
-    uint8 m_buffer[BUFFER_MAXSIZE];
+    uint8* m_buffer;
+    uint8 m_ownBuffer[BUFFER_MAXSIZE];
 };
 
 #endif
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "networkthread.h"
+#include "connection.h"
+#include "protocol.h"
+
+extern asio::io_service g_ioService;
+
+NetworkThread g_network;
+
+void NetworkThread::init()
+{
+    // keeps the io service running while there is no pending operation
+    m_work = std::make_unique<asio::io_service::work>(g_ioService);
+    m_running = true;
+    m_thread = std::thread([this] {
+        while(m_running) {
+            try {
+                g_ioService.run();
+                break;
+            } catch(std::exception& e) {
+                const std::string what = e.what();
+                dispatch([what] { g_logger.error(stdext::format("Network thread exception: %s", what)); });
+            }
+        }
+    });
+    m_threadId = m_thread.get_id();
+}
+
+void NetworkThread::terminate()
+{
+    m_running = false;
+    m_work.reset();
+    g_ioService.stop();
+    if(m_thread.joinable())
+        m_thread.join();
+
+    // release everything left behind without running any callback
+    Event event;
+    while(m_events.pop(event))
+        releaseEvent(event);
+
+    OutputBuffer* outputBuffer;
+    while(m_outputBuffers.pop(outputBuffer)) {
+        outputBuffer->connection->dec_ref();
+        delete outputBuffer;
+    }
+    while(m_freeOutputBuffers.pop(outputBuffer))
+        delete outputBuffer;
+
+    InputMessage* inputMessage;
+    while(m_freeInputMessages.pop(inputMessage))
+        inputMessage->dec_ref();
+}
+
+void NetworkThread::poll()
+{
+    Event event;
+    while(m_events.pop(event)) {
+        if(event.callback) {
+            (*event.callback)();
+        } else if(event.protocol && event.inputMessage) {
+            const ConnectionPtr connection = event.protocol->getConnection();
+
+            // ignore messages that arrived after the protocol was disconnected
+            if(connection) {
+                connection->m_activityTimer.restart();
+                event.protocol->onRecv(event.inputMessage);
+            }
+
+            // recycle the message unless lua is still holding it
+            if(event.inputMessage->ref_count() == 1 && m_freeInputMessages.push(event.inputMessage))
+                event.inputMessage = nullptr;
+        }
+        releaseEvent(event);
+    }
+
+    schedulePendingWrites();
+}
+
+void NetworkThread::post(const std::function<void()>& callback)
+{
+    // writes queued before must reach the socket before the task runs (e.g. a close)
+    schedulePendingWrites();
+
+    auto task = new std::function<void()>(callback);
+    g_ioService.post([this, task] {
+        (*task)();
+
+        // objects captured by the task may be lua objects, destroy them in the main thread
+        dispatch([released = std::move(*task)] {});
+        delete task;
+    });
+}
+
+void NetworkThread::write(const ConnectionPtr& connection, const uint8* buffer, size_t size)
+{
+    OutputBuffer* outputBuffer;
+    if(!m_freeOutputBuffers.pop(outputBuffer))
+        outputBuffer = new OutputBuffer;
+
+    connection->add_ref();
+    outputBuffer->connection = connection.get();
+    outputBuffer->data.assign(buffer, buffer + size);
+
+    // buffers are only flushed after the current poll, as the main loop did before,
+    // so protocol state changes made right after a send are visible to the network thread
+    while(!m_outputBuffers.push(outputBuffer)) {
+        g_ioService.post([this] { flush(); });
+        std::this_thread::yield();
+    }
+    m_pendingWrites = true;
+}
+
+void NetworkThread::dispatch(const std::function<void()>& callback)
+{
+    pushEvent({ nullptr, nullptr, new std::function<void()>(callback) });
+}
+
+void NetworkThread::dispatchMessage(const ProtocolPtr& protocol, const InputMessagePtr& inputMessage)
+{
+    protocol->add_ref();
+    inputMessage->add_ref();
+    pushEvent({ protocol.get(), inputMessage.get(), nullptr });
+}
+
+InputMessagePtr NetworkThread::acquireInputMessage()
+{
+    InputMessage* inputMessage;
+    if(m_freeInputMessages.pop(inputMessage))
+        return InputMessagePtr(inputMessage, false);
+    return InputMessagePtr(new InputMessage);
+}
+
+void NetworkThread::pushEvent(const Event& event)
+{
+    // the main thread is lagging behind, wait for it to catch up
+    while(!m_events.push(event)) {
+        // nobody will ever consume it, leak it rather than releasing lua objects here
+        if(!m_running)
+            return;
+        std::this_thread::yield();
+    }
+}
+
+void NetworkThread::releaseEvent(const Event& event)
+{
+    if(event.protocol)
+        event.protocol->dec_ref();
+    if(event.inputMessage)
+        event.inputMessage->dec_ref();
+    delete event.callback;
+}
+
+void NetworkThread::schedulePendingWrites()
+{
+    if(m_pendingWrites) {
+        m_pendingWrites = false;
+        g_ioService.post([this] { flush(); });
+    }
+}
+
+void NetworkThread::flush()
+{
+    OutputBuffer* outputBuffer;
+    while(m_outputBuffers.pop(outputBuffer)) {
+        const ConnectionPtr connection(outputBuffer->connection, false);
+        outputBuffer->connection = nullptr;
+        connection->write(outputBuffer->data.data(), outputBuffer->data.size());
+
+        if(!m_freeOutputBuffers.push(outputBuffer))
+            delete outputBuffer;
+    }
+}
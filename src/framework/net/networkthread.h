@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORKTHREAD_H
+#define NETWORKTHREAD_H
+
+#include "declarations.h"
+#include <framework/stdext/thread.h>
+
+#include <atomic>
+#include <boost/lockfree/spsc_queue.hpp>
+
+/// Runs the io service in a dedicated thread, so messages are read, framed,
+/// verified and decrypted as soon as they arrive instead of once per frame.
+/// Complete messages are handed to the main thread through a lock-free queue
+/// (and outgoing buffers travel the other way), parsing stays in the main thread.
+/// Lua objects referenced from the network thread are always released in the main thread.
+class NetworkThread
+{
+    enum {
+        EVENT_QUEUE_SIZE = 4096,
+        BUFFER_QUEUE_SIZE = 1024
+    };
+
+public:
+    void init();
+    void terminate();
+
+    /// Executes events produced by the network thread and flushes pending writes, main thread only
+    void poll();
+
+    bool isCurrentThread() { return std::this_thread::get_id() == m_threadId; }
+
+    /// Runs a callback in the network thread, the callback is destroyed in the main thread
+    void post(const std::function<void()>& callback);
+    /// Queues a copy of the buffer to be written by the network thread
+    void write(const ConnectionPtr& connection, const uint8* buffer, size_t size);
+
+    /// Runs a callback in the main thread, network thread only
+    void dispatch(const std::function<void()>& callback);
+    /// Hands a complete message to the main thread, network thread only
+    void dispatchMessage(const ProtocolPtr& protocol, const InputMessagePtr& inputMessage);
+    /// Returns a message recycled by the main thread or a new one, network thread only
+    InputMessagePtr acquireInputMessage();
+
+private:
+    struct Event {
+        Protocol* protocol;
+        InputMessage* inputMessage;
+        std::function<void()>* callback;
+    };
+
+    struct OutputBuffer {
+        Connection* connection;
+        std::vector<uint8> data;
+    };
+
+    void pushEvent(const Event& event);
+    void releaseEvent(const Event& event);
+    void schedulePendingWrites();
+    void flush();
+
+    std::thread m_thread;
+    std::thread::id m_threadId;
+    std::unique_ptr<asio::io_service::work> m_work;
+    std::atomic<bool> m_running{ false };
+    bool m_pendingWrites{ false };
+
+    // network thread -> main thread
+    boost::lockfree::spsc_queue<Event, boost::lockfree::capacity<EVENT_QUEUE_SIZE>> m_events;
+    boost::lockfree::spsc_queue<OutputBuffer*, boost::lockfree::capacity<BUFFER_QUEUE_SIZE>> m_freeOutputBuffers;
+
+    // main thread -> network thread
+    boost::lockfree::spsc_queue<OutputBuffer*, boost::lockfree::capacity<BUFFER_QUEUE_SIZE>> m_outputBuffers;
+    boost::lockfree::spsc_queue<InputMessage*, boost::lockfree::capacity<BUFFER_QUEUE_SIZE>> m_freeInputMessages;
+};
+
+extern NetworkThread g_network;
+
+#endif
@@ -25,11 +25,60 @@
 
 #include "framework/stdext/math.h"
 
-OutputMessage::OutputMessage()
+#ifdef THREAD_SAFE
+#include <mutex>
+#endif
+
+namespace {
+    constexpr size_t MAX_FREE_MESSAGES = 64;
+
+    // free blocks are chained through their first bytes, plain data so it outlives every message
+    struct FreeMessage { FreeMessage* next; };
+    FreeMessage* freeMessages = nullptr;
+    size_t freeMessageCount = 0;
+
+#ifdef THREAD_SAFE
+    std::mutex freeMessagesMutex;
+#endif
+}
+
+OutputMessage::OutputMessage() : m_buffer(m_inlineBuffer), m_capacity(INLINE_BUFFER_SIZE)
 {
     reset();
 }
 
+void* OutputMessage::operator new(size_t size)
+{
+    if(size == sizeof(OutputMessage)) {
+#ifdef THREAD_SAFE
+        std::lock_guard<std::mutex> lock(freeMessagesMutex);
+#endif
+        if(FreeMessage* message = freeMessages) {
+            freeMessages = message->next;
+            --freeMessageCount;
+            return message;
+        }
+    }
+
+    return ::operator new(size);
+}
+
+void OutputMessage::operator delete(void* p, size_t size)
+{
+    if(p && size == sizeof(OutputMessage)) {
+#ifdef THREAD_SAFE
+        std::lock_guard<std::mutex> lock(freeMessagesMutex);
+#endif
+        if(freeMessageCount < MAX_FREE_MESSAGES) {
+            freeMessages = new(p) FreeMessage{ freeMessages };
+            ++freeMessageCount;
+            return;
+        }
+    }
+
+    ::operator delete(p);
+}
+
 void OutputMessage::reset()
 {
     m_writePos = MAX_HEADER_SIZE;
@@ -113,7 +162,11 @@ void OutputMessage::encryptRsa()
 
 void OutputMessage::writeChecksum()
 {
-    const uint32 checksum = stdext::adler32(m_buffer + m_headerPos, m_messageSize);
+    writeChecksum(stdext::adler32(m_buffer + m_headerPos, m_messageSize));
+}
+
+void OutputMessage::writeChecksum(uint32 checksum)
+{
     assert(m_headerPos - 4 >= 0);
     m_headerPos -= 4;
     stdext::writeULE32(m_buffer + m_headerPos, checksum);
@@ -139,4 +192,19 @@ void OutputMessage::checkWrite(int bytes)
 {
     if(!canWrite(bytes))
         throw stdext::exception("OutputMessage max buffer size reached");
+
+    if(m_writePos + bytes > m_capacity)
+        grow(m_writePos + bytes);
+}
+
+void OutputMessage::grow(int size)
+{
+    const int capacity = std::min<int>(std::max<int>(size, m_capacity * 2), BUFFER_MAXSIZE);
+
+    uint8* buffer = new uint8[capacity];
+    memcpy(buffer, m_buffer, std::min<int>(m_writePos, m_capacity));
+
+    m_heapBuffer.reset(buffer);
+    m_buffer = buffer;
+    m_capacity = capacity;
 }
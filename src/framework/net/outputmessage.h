@@ -33,11 +33,16 @@ public:
     enum {
         BUFFER_MAXSIZE = 65536,
         MAX_STRING_LENGTH = 65536,
-        MAX_HEADER_SIZE = 8
+        MAX_HEADER_SIZE = 8,
+        INLINE_BUFFER_SIZE = 256
     };
 
     OutputMessage();
 
+    // most messages are a few bytes sent once, their memory is recycled instead of going to the heap
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+
     void reset();
 
     void setBuffer(const std::string& buffer);
@@ -64,6 +69,7 @@ protected:
     uint8* getDataBuffer() { return m_buffer + MAX_HEADER_SIZE; }
 
     void writeChecksum();
+    void writeChecksum(uint32 checksum);
     void writeMessageSize();
 
     friend class Protocol;
@@ -71,11 +77,17 @@ protected:
 private:
     bool canWrite(int bytes);
     void checkWrite(int bytes);
+    void grow(int size);
 
     uint16 m_headerPos;
     uint16 m_writePos;
     uint16 m_messageSize;
-    uint8 m_buffer[BUFFER_MAXSIZE];
+
+    // starts on the inline buffer, moves to the heap for bigger messages
+    uint8* m_buffer;
+    int m_capacity;
+    std::unique_ptr<uint8[]> m_heapBuffer;
+    uint8 m_inlineBuffer[INLINE_BUFFER_SIZE];
 };
 
 #endif
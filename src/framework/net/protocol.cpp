@@ -22,9 +22,28 @@
 
 #include "protocol.h"
 #include "connection.h"
+#include "xtea.h"
 #include <framework/core/application.h>
 #include <random>
 
+#ifdef FW_NET_THREAD
+#include "networkthread.h"
+#endif
+
+namespace {
+    void reportError(const std::string& message)
+    {
+#ifdef FW_NET_THREAD
+        // the logger may run lua code, so errors found in the network thread are logged by the main thread
+        if(g_network.isCurrentThread()) {
+            g_network.dispatch([message] { g_logger.error(message); });
+            return;
+        }
+#endif
+        g_logger.traceError(message);
+    }
+}
+
 Protocol::Protocol()
 {
     m_xteaEncryptionEnabled = false;
@@ -42,6 +61,13 @@ Protocol::~Protocol()
 
 void Protocol::connect(const std::string& host, uint16 port)
 {
+    // a read pending on a previous connection was aborted without reaching us
+#ifdef FW_NET_THREAD
+    g_network.post([capture0 = asProtocol()] { capture0->resetRecv(); });
+#else
+    resetRecv();
+#endif
+
     m_connection = ConnectionPtr(new Connection);
     m_connection->setErrorCallback([capture0 = asProtocol()](auto&& PH1)
     {
@@ -74,12 +100,10 @@ bool Protocol::isConnecting()
 
 void Protocol::send(const OutputMessagePtr& outputMessage)
 {
-    // encrypt
+    // encrypt, the checksum of encrypted messages is written while encrypting
     if(m_xteaEncryptionEnabled)
         xteaEncrypt(outputMessage);
-
-    // write checksum
-    if(m_checksumEnabled)
+    else if(m_checksumEnabled)
         outputMessage->writeChecksum();
 
     // write message size
@@ -95,62 +119,146 @@ void Protocol::send(const OutputMessagePtr& outputMessage)
 
 void Protocol::recv()
 {
-    m_inputMessage->reset();
+    if(!m_connection)
+        return;
 
-    // first update message header size
-    int headerSize = 2; // 2 bytes for message size
-    if(m_checksumEnabled)
-        headerSize += 4; // 4 bytes for checksum
-    if(m_xteaEncryptionEnabled)
-        headerSize += 2; // 2 bytes for XTEA encrypted message size
-    m_inputMessage->setHeaderSize(headerSize);
+#ifdef FW_NET_THREAD
+    // the network thread does the reading
+    if(!g_network.isCurrentThread()) {
+        g_network.post([capture0 = asProtocol(), connection = m_connection]
+        {
+            if(!capture0->m_receiving)
+                capture0->internalRecv(connection);
+        });
+        return;
+    }
+#endif
 
-    // read the first 2 bytes which contain the message size
-    if(m_connection)
-        m_connection->read(2, [capture0 = asProtocol()](auto&& PH1, auto&& PH2)
-    {
-        capture0->internalRecvHeader(std::forward<decltype(PH1)>(PH1),
-                                     std::forward<decltype(PH2)>(PH2));
-    });
+    // once started it keeps reading until disconnected, so this only starts it
+    if(!m_receiving)
+        internalRecv(m_connection);
 }
 
-void Protocol::internalRecvHeader(uint8* buffer, uint16 size)
+void Protocol::internalRecv(const ConnectionPtr& connection)
 {
-    // read message size
-    m_inputMessage->fillBuffer(buffer, size);
-    const uint16 remainingSize = m_inputMessage->readSize();
+    if(m_recvBuffer.empty())
+        m_recvBuffer.resize(RECV_BUFFER_SIZE);
 
-    // read remaining message data
-    if(m_connection)
-        m_connection->read(remainingSize, [capture0 = asProtocol()](auto&& PH1, auto&& PH2)
+    m_receiving = true;
+
+    // read whatever is available, possibly many messages at once
+    const uint16 freeSize = std::min<uint32>(m_recvBuffer.size() - m_recvEnd, UINT16_MAX);
+    connection->read_some(m_recvBuffer.data() + m_recvEnd, freeSize, [capture0 = asProtocol(), connection](uint8*, uint16 size)
     {
-        capture0->internalRecvData(std::forward<decltype(PH1)>(PH1),
-                                   std::forward<decltype(PH2)>(PH2));
+        capture0->internalRecvData(connection, size);
     });
 }
 
-void Protocol::internalRecvData(uint8* buffer, uint16 size)
+void Protocol::internalRecvData(ConnectionPtr connection, uint16 size)
 {
+    // the read callback holding the references may be released while parsing (e.g. on disconnect)
+    const ProtocolPtr self = asProtocol();
+
     // process data only if really connected
-    if(!isConnected()) {
-        g_logger.traceError("received data while disconnected");
+    if(!connection->isConnected()) {
+        resetRecv();
+        reportError("received data while disconnected");
         return;
     }
 
-    m_inputMessage->fillBuffer(buffer, size);
+    m_recvEnd += size;
 
-    if(m_checksumEnabled && !m_inputMessage->readChecksum()) {
-        g_logger.traceError("got a network message with invalid checksum");
-        return;
+    // parse every complete message received so far
+    while(m_recvEnd - m_recvBegin >= 2) {
+        uint8* frame = m_recvBuffer.data() + m_recvBegin;
+        const int frameSize = 2 + stdext::readULE16(frame);
+        if(m_recvEnd - m_recvBegin < static_cast<uint32>(frameSize))
+            break;
+
+        m_recvBegin += frameSize;
+
+        // the message must fit in an input message after its header
+        if(InputMessage::MAX_HEADER_SIZE - getHeaderSize() + frameSize > InputMessage::BUFFER_MAXSIZE) {
+            m_receiving = false;
+            reportError("got a network message with invalid size");
+            return;
+        }
+
+        if(!internalRecvMessage(frame, frameSize)) {
+            m_receiving = false;
+            return;
+        }
+
+        // the message may have caused a disconnect
+        if(!connection->isConnected()) {
+            resetRecv();
+            return;
+        }
     }
 
+    // keep enough room after the pending data for the largest possible message,
+    // moving it to the front only when needed as it's usually just a few bytes
+    if(m_recvBegin == m_recvEnd)
+        m_recvBegin = m_recvEnd = InputMessage::MAX_HEADER_SIZE;
+    else if(m_recvBegin > RECV_BUFFER_SIZE - MAX_FRAME_SIZE) {
+        const uint32 pendingSize = m_recvEnd - m_recvBegin;
+        memmove(m_recvBuffer.data() + InputMessage::MAX_HEADER_SIZE, m_recvBuffer.data() + m_recvBegin, pendingSize);
+        m_recvBegin = InputMessage::MAX_HEADER_SIZE;
+        m_recvEnd = m_recvBegin + pendingSize;
+    }
+
+    internalRecv(connection);
+}
+
+bool Protocol::internalRecvMessage(uint8* frame, uint16 frameSize)
+{
+    m_inputMessage->reset();
+    m_inputMessage->setHeaderSize(getHeaderSize());
+
+#ifdef FW_NET_THREAD
+    // the main thread parses it later, while the receive buffer is already being reused
+    m_inputMessage->fillBuffer(frame, frameSize);
+#else
+    // parsed before anything else is read, so there is no need to copy it
+    m_inputMessage->wrapBuffer(frame, frameSize);
+#endif
+
+    m_inputMessage->readSize();
+
+    // decrypting also verifies the checksum
     if(m_xteaEncryptionEnabled) {
         if(!xteaDecrypt(m_inputMessage)) {
-            g_logger.traceError("failed to decrypt message");
-            return;
+            reportError("failed to decrypt message");
+            return false;
         }
+    } else if(m_checksumEnabled && !m_inputMessage->readChecksum()) {
+        reportError("got a network message with invalid checksum");
+        return false;
     }
+
+#ifdef FW_NET_THREAD
+    g_network.dispatchMessage(asProtocol(), m_inputMessage);
+    m_inputMessage = g_network.acquireInputMessage();
+#else
     onRecv(m_inputMessage);
+#endif
+    return true;
+}
+
+void Protocol::resetRecv()
+{
+    m_receiving = false;
+    m_recvBegin = m_recvEnd = InputMessage::MAX_HEADER_SIZE;
+}
+
+int Protocol::getHeaderSize()
+{
+    int headerSize = 2; // 2 bytes for message size
+    if(m_checksumEnabled)
+        headerSize += 4; // 4 bytes for checksum
+    if(m_xteaEncryptionEnabled)
+        headerSize += 2; // 2 bytes for XTEA encrypted message size
+    return headerSize;
 }
 
 void Protocol::generateXteaKey()
@@ -160,49 +268,30 @@ void Protocol::generateXteaKey()
     std::generate(m_xteaKey.begin(), m_xteaKey.end(), [&]() { return unif(rd); });
 }
 
-namespace {
-    constexpr uint32_t delta = 0x9E3779B9;
-
-    template<typename Round>
-    void apply_rounds(uint8_t* data, size_t length, Round round)
-    {
-        for(auto j = 0u; j < length; j += 8) {
-            uint32_t left = data[j + 0] | data[j + 1] << 8u | data[j + 2] << 16u | data[j + 3] << 24u,
-                right = data[j + 4] | data[j + 5] << 8u | data[j + 6] << 16u | data[j + 7] << 24u;
-
-            round(left, right);
-
-            data[j] = static_cast<uint8_t>(left);
-            data[j + 1] = static_cast<uint8_t>(left >> 8u);
-            data[j + 2] = static_cast<uint8_t>(left >> 16u);
-            data[j + 3] = static_cast<uint8_t>(left >> 24u);
-            data[j + 4] = static_cast<uint8_t>(right);
-            data[j + 5] = static_cast<uint8_t>(right >> 8u);
-            data[j + 6] = static_cast<uint8_t>(right >> 16u);
-            data[j + 7] = static_cast<uint8_t>(right >> 24u);
-        }
-    }
-}
-
 bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage)
 {
+    // the checksum covers the encrypted data, so it's computed while decrypting
+    uint32 receivedChecksum = 0;
+    if(m_checksumEnabled)
+        receivedChecksum = inputMessage->getU32();
+
     const uint16 encryptedSize = inputMessage->getUnreadSize();
     if(encryptedSize % 8 != 0) {
-        g_logger.traceError("invalid encrypted network message");
+        reportError("invalid encrypted network message");
         return false;
     }
 
-    for(uint32_t i = 0, sum = delta << 5, next_sum = sum - delta; i < 32; ++i, sum = next_sum, next_sum -= delta) {
-        apply_rounds(inputMessage->getReadBuffer(), encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            right -= ((left << 4 ^ left >> 5) + left) ^ (sum + m_xteaKey[(sum >> 11) & 3]);
-            left -= ((right << 4 ^ right >> 5) + right) ^ (next_sum + m_xteaKey[next_sum & 3]);
-        });
+    uint32 checksum = 0;
+    xtea::decrypt(inputMessage->getReadBuffer(), encryptedSize, m_xteaKey, m_checksumEnabled ? &checksum : nullptr);
+    if(checksum != receivedChecksum) {
+        reportError("got a network message with invalid checksum");
+        return false;
     }
 
     const uint16 decryptedSize = inputMessage->getU16() + 2;
     const int sizeDelta = decryptedSize - encryptedSize;
     if(sizeDelta > 0 || -sizeDelta > encryptedSize) {
-        g_logger.traceError("invalid decrypted network message");
+        reportError("invalid decrypted network message");
         return false;
     }
 
@@ -222,12 +311,13 @@ void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage)
         encryptedSize += n;
     }
 
-    for(uint32_t i = 0, sum = 0, next_sum = sum + delta; i < 32; ++i, sum = next_sum, next_sum += delta) {
-        apply_rounds(outputMessage->getDataBuffer() - 2, encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            left += ((right << 4 ^ right >> 5) + right) ^ (sum + m_xteaKey[sum & 3]);
-            right += ((left << 4 ^ left >> 5) + left) ^ (next_sum + m_xteaKey[(next_sum >> 11) & 3]);
-        });
-    }
+    // the checksum covers the encrypted data, so it's computed while encrypting
+    if(m_checksumEnabled) {
+        uint32 checksum;
+        xtea::encrypt(outputMessage->getHeaderBuffer(), encryptedSize, m_xteaKey, &checksum);
+        outputMessage->writeChecksum(checksum);
+    } else
+        xtea::encrypt(outputMessage->getHeaderBuffer(), encryptedSize, m_xteaKey);
 }
 
 void Protocol::onConnect()
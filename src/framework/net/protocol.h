@@ -30,6 +30,8 @@
 
 #include <framework/luaengine/luaobject.h>
 
+#include <atomic>
+
  // @bindclass
 class Protocol : public LuaObject
 {
@@ -67,16 +69,33 @@ protected:
     std::array<uint32, 4> m_xteaKey;
 
 private:
-    void internalRecvHeader(uint8* buffer, uint16 size);
-    void internalRecvData(uint8* buffer, uint16 size);
+    enum {
+        RECV_BUFFER_SIZE = InputMessage::MAX_HEADER_SIZE + 2 * InputMessage::BUFFER_MAXSIZE,
+        MAX_FRAME_SIZE = 2 + UINT16_MAX
+    };
+
+    void internalRecv(const ConnectionPtr& connection);
+    void internalRecvData(ConnectionPtr connection, uint16 size);
+    bool internalRecvMessage(uint8* frame, uint16 frameSize);
+    void resetRecv();
+    int getHeaderSize();
 
     bool xteaDecrypt(const InputMessagePtr& inputMessage);
     void xteaEncrypt(const OutputMessagePtr& outputMessage);
 
-    bool m_checksumEnabled;
-    bool m_xteaEncryptionEnabled;
+    // also read by the network thread when it's enabled
+    std::atomic<bool> m_checksumEnabled;
+    std::atomic<bool> m_xteaEncryptionEnabled;
     ConnectionPtr m_connection;
     InputMessagePtr m_inputMessage;
+
+    // received data, complete messages are parsed straight from here
+    std::vector<uint8> m_recvBuffer;
+    uint32 m_recvBegin{ InputMessage::MAX_HEADER_SIZE };
+    uint32 m_recvEnd{ InputMessage::MAX_HEADER_SIZE };
+    bool m_receiving{ false };
+
+    friend class NetworkThread;
 };
 
 #endif
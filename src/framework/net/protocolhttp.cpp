@@ -24,6 +24,10 @@
 #include "connection.h"
 #include <framework/core/application.h>
 
+#ifdef FW_NET_THREAD
+#include "networkthread.h"
+#endif
+
 ProtocolHttp::ProtocolHttp()
 = default;
 
@@ -77,6 +81,13 @@ void ProtocolHttp::onConnect()
 void ProtocolHttp::onRecv(uint8* buffer, uint16 size)
 {
     const auto string = std::string((char*)buffer, static_cast<size_t>(size));
+#ifdef FW_NET_THREAD
+    // received by the network thread, but lua must run in the main thread
+    if(g_network.isCurrentThread()) {
+        g_network.dispatch([capture0 = asProtocolHttp(), string] { capture0->callLuaField("onRecv", string); });
+        return;
+    }
+#endif
     callLuaField("onRecv", string);
 }
 
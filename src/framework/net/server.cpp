@@ -23,6 +23,10 @@
 #include "server.h"
 #include "connection.h"
 
+#ifdef FW_NET_THREAD
+#include "networkthread.h"
+#endif
+
 extern asio::io_service g_ioService;
 
 Server::Server(int port)
@@ -52,12 +56,19 @@ void Server::acceptNext()
 {
     auto connection = ConnectionPtr(new Connection);
     connection->m_connecting = true;
-    const auto self = static_self_cast<Server>();
-    m_acceptor.async_accept(connection->m_socket, [=](const boost::system::error_code& error) {
+    auto self = static_self_cast<Server>();
+    m_acceptor.async_accept(connection->m_socket, [=](const boost::system::error_code& error) mutable {
         if(!error) {
             connection->m_connected = true;
             connection->m_connecting = false;
         }
+#ifdef FW_NET_THREAD
+        // accepted by the network thread, the server must be released in the main thread too
+        g_network.dispatch([self = std::move(self), connection, error] {
+            self->callLuaField("onAccept", connection, error.message(), error.value());
+        });
+#else
         self->callLuaField("onAccept", connection, error.message(), error.value());
+#endif
     });
 }
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "xtea.h"
+#include <framework/core/logger.h>
+#include <framework/stdext/math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XTEA_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define XTEA_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define XTEA_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+    constexpr uint32 delta = 0x9E3779B9;
+    constexpr size_t rounds = 32;
+
+    // both halves of every block are updated with a round key per round,
+    // they only depend on the key so they're computed once per buffer
+    struct RoundKeys
+    {
+        uint32 first[rounds];
+        uint32 second[rounds];
+    };
+
+    RoundKeys encryptKeys(const xtea::Key& key)
+    {
+        RoundKeys keys;
+        for(uint32 i = 0, sum = 0, next_sum = sum + delta; i < rounds; ++i, sum = next_sum, next_sum += delta) {
+            keys.first[i] = sum + key[sum & 3];
+            keys.second[i] = next_sum + key[(next_sum >> 11) & 3];
+        }
+        return keys;
+    }
+
+    RoundKeys decryptKeys(const xtea::Key& key)
+    {
+        RoundKeys keys;
+        for(uint32 i = 0, sum = delta << 5, next_sum = sum - delta; i < rounds; ++i, sum = next_sum, next_sum -= delta) {
+            keys.first[i] = sum + key[(sum >> 11) & 3];
+            keys.second[i] = next_sum + key[next_sum & 3];
+        }
+        return keys;
+    }
+
+    template<bool Encrypt>
+    void cryptScalar(uint8* data, size_t size, const RoundKeys& keys)
+    {
+        for(size_t j = 0; j < size; j += 8) {
+            uint32 left = stdext::readULE32(data + j), right = stdext::readULE32(data + j + 4);
+
+            for(size_t i = 0; i < rounds; ++i) {
+                if(Encrypt) {
+                    left += ((right << 4 ^ right >> 5) + right) ^ keys.first[i];
+                    right += ((left << 4 ^ left >> 5) + left) ^ keys.second[i];
+                } else {
+                    right -= ((left << 4 ^ left >> 5) + left) ^ keys.first[i];
+                    left -= ((right << 4 ^ right >> 5) + right) ^ keys.second[i];
+                }
+            }
+
+            stdext::writeULE32(data + j, left);
+            stdext::writeULE32(data + j + 4, right);
+        }
+    }
+
+#ifdef XTEA_SSE2
+    inline __m128i mix(__m128i v) { return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v); }
+
+    // 4 blocks at once, the left and right halves of each block go to separate registers
+    template<bool Encrypt>
+    void cryptSse2(uint8* data, size_t size, const RoundKeys& keys)
+    {
+        size_t j = 0;
+        for(; j + 32 <= size; j += 32) {
+            const __m128i a = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j)), _MM_SHUFFLE(3, 1, 2, 0));
+            const __m128i b = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i left = _mm_unpacklo_epi64(a, b);
+            __m128i right = _mm_unpackhi_epi64(a, b);
+
+            for(size_t i = 0; i < rounds; ++i) {
+                if(Encrypt) {
+                    left = _mm_add_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(keys.first[i])));
+                    right = _mm_add_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(keys.second[i])));
+                } else {
+                    right = _mm_sub_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(keys.first[i])));
+                    left = _mm_sub_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(keys.second[i])));
+                }
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + j), _mm_unpacklo_epi32(left, right));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + j + 16), _mm_unpackhi_epi32(left, right));
+        }
+        cryptScalar<Encrypt>(data + j, size - j, keys);
+    }
+#endif
+
+#ifdef XTEA_AVX2
+#ifdef __GNUC__
+#define XTEA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XTEA_TARGET_AVX2
+#endif
+
+    XTEA_TARGET_AVX2 inline __m256i mix(__m256i v) { return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v); }
+
+    // 8 blocks at once, same layout as the sse2 version within each 128 bits lane
+    template<bool Encrypt>
+    XTEA_TARGET_AVX2 void cryptAvx2(uint8* data, size_t size, const RoundKeys& keys)
+    {
+        size_t j = 0;
+        for(; j + 64 <= size; j += 64) {
+            const __m256i a = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + j)), _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256i b = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + j + 32)), _MM_SHUFFLE(3, 1, 2, 0));
+            __m256i left = _mm256_unpacklo_epi64(a, b);
+            __m256i right = _mm256_unpackhi_epi64(a, b);
+
+            for(size_t i = 0; i < rounds; ++i) {
+                if(Encrypt) {
+                    left = _mm256_add_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(keys.first[i])));
+                    right = _mm256_add_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(keys.second[i])));
+                } else {
+                    right = _mm256_sub_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(keys.first[i])));
+                    left = _mm256_sub_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(keys.second[i])));
+                }
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + j), _mm256_unpacklo_epi32(left, right));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + j + 32), _mm256_unpackhi_epi32(left, right));
+        }
+        cryptSse2<Encrypt>(data + j, size - j, keys);
+    }
+#endif
+
+#ifdef XTEA_NEON
+    inline uint32x4_t mix(uint32x4_t v) { return vaddq_u32(veorq_u32(vshlq_n_u32(v, 4), vshrq_n_u32(v, 5)), v); }
+
+    // 4 blocks at once, the interleaved load already splits the halves
+    template<bool Encrypt>
+    void cryptNeon(uint8* data, size_t size, const RoundKeys& keys)
+    {
+        size_t j = 0;
+        for(; j + 32 <= size; j += 32) {
+            uint32x4x2_t blocks = vld2q_u32(reinterpret_cast<const uint32_t*>(data + j));
+            uint32x4_t& left = blocks.val[0];
+            uint32x4_t& right = blocks.val[1];
+
+            for(size_t i = 0; i < rounds; ++i) {
+                if(Encrypt) {
+                    left = vaddq_u32(left, veorq_u32(mix(right), vdupq_n_u32(keys.first[i])));
+                    right = vaddq_u32(right, veorq_u32(mix(left), vdupq_n_u32(keys.second[i])));
+                } else {
+                    right = vsubq_u32(right, veorq_u32(mix(left), vdupq_n_u32(keys.first[i])));
+                    left = vsubq_u32(left, veorq_u32(mix(right), vdupq_n_u32(keys.second[i])));
+                }
+            }
+
+            vst2q_u32(reinterpret_cast<uint32_t*>(data + j), blocks);
+        }
+        cryptScalar<Encrypt>(data + j, size - j, keys);
+    }
+#endif
+
+    using CryptFunction = void(*)(uint8*, size_t, const RoundKeys&);
+
+    // set by selfCheck when a vectorized path gives wrong results on this cpu
+    bool useScalar = false;
+
+    template<bool Encrypt>
+    CryptFunction selectCrypt()
+    {
+        if(useScalar)
+            return cryptScalar<Encrypt>;
+#ifdef XTEA_AVX2
+        if(stdext::cpu_supports_avx2())
+            return cryptAvx2<Encrypt>;
+#endif
+#if defined(XTEA_SSE2)
+        return cryptSse2<Encrypt>;
+#elif defined(XTEA_NEON)
+        return cryptNeon<Encrypt>;
+#else
+        return cryptScalar<Encrypt>;
+#endif
+    }
+
+    // the checksum is updated chunk by chunk while the data is still in cache,
+    // chunks also stay below the size where adler32 sums could overflow
+    constexpr size_t chunkSize = 4096;
+
+    void updateAdler(uint32& a, uint32& b, const uint8* data, size_t size)
+    {
+        for(size_t i = 0; i < size; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+
+    template<bool Encrypt>
+    void crypt(uint8* data, size_t size, const RoundKeys& keys, uint32* checksum)
+    {
+        static const CryptFunction cryptFunction = selectCrypt<Encrypt>();
+
+        if(!checksum) {
+            cryptFunction(data, size, keys);
+            return;
+        }
+
+        uint32 a = 1, b = 0;
+        for(size_t j = 0; j < size; j += chunkSize) {
+            const size_t length = std::min<size_t>(chunkSize, size - j);
+            if(Encrypt) {
+                cryptFunction(data + j, length, keys);
+                updateAdler(a, b, data + j, length);
+            } else {
+                updateAdler(a, b, data + j, length);
+                cryptFunction(data + j, length, keys);
+            }
+        }
+        *checksum = b << 16 | a;
+    }
+
+    // reference vector for 32 rounds (key 00010203 04050607 08090a0b 0c0d0e0f, block 41424344 45464748)
+    const xtea::Key testKey = { 0x00010203, 0x04050607, 0x08090A0B, 0x0C0D0E0F };
+    constexpr uint32 testPlain[2] = { 0x41424344, 0x45464748 };
+    constexpr uint32 testCipher[2] = { 0x497DF3D0, 0x72612CB5 };
+
+    // reaches the 64 and 32 bytes blocks of every vectorized path and their scalar tail
+    constexpr size_t testSize = 200;
+
+    uint8 testByte(size_t i) { return static_cast<uint8>(i * 7 + 3); }
+
+    bool checkScalar()
+    {
+        uint8 block[8];
+        stdext::writeULE32(block, testPlain[0]);
+        stdext::writeULE32(block + 4, testPlain[1]);
+        cryptScalar<true>(block, 8, encryptKeys(testKey));
+        if(stdext::readULE32(block) != testCipher[0] || stdext::readULE32(block + 4) != testCipher[1])
+            return false;
+
+        cryptScalar<false>(block, 8, decryptKeys(testKey));
+        return stdext::readULE32(block) == testPlain[0] && stdext::readULE32(block + 4) == testPlain[1];
+    }
+
+    bool checkCrypt(CryptFunction encrypt, CryptFunction decrypt)
+    {
+        uint8 expected[testSize], data[testSize];
+        for(size_t i = 0; i < testSize; ++i)
+            expected[i] = data[i] = testByte(i);
+
+        cryptScalar<true>(expected, testSize, encryptKeys(testKey));
+        encrypt(data, testSize, encryptKeys(testKey));
+        if(memcmp(expected, data, testSize) != 0)
+            return false;
+
+        decrypt(data, testSize, decryptKeys(testKey));
+        for(size_t i = 0; i < testSize; ++i) {
+            if(data[i] != testByte(i))
+                return false;
+        }
+        return true;
+    }
+
+    bool checkChecksum()
+    {
+        // adler32 of "Wikipedia"
+        uint32 a = 1, b = 0;
+        updateAdler(a, b, reinterpret_cast<const uint8*>("Wikipedia"), 9);
+        if((b << 16 | a) != 0x11E60398)
+            return false;
+
+        // spans several checksum chunks, the checksum always covers the encrypted data
+        std::vector<uint8> data(2 * chunkSize + testSize);
+        for(size_t i = 0; i < data.size(); ++i)
+            data[i] = testByte(i);
+
+        uint32 encryptChecksum;
+        crypt<true>(data.data(), data.size(), encryptKeys(testKey), &encryptChecksum);
+
+        a = 1;
+        b = 0;
+        for(const uint8 byte : data) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        uint32 decryptChecksum;
+        crypt<false>(data.data(), data.size(), decryptKeys(testKey), &decryptChecksum);
+        return encryptChecksum == (b << 16 | a) && decryptChecksum == encryptChecksum;
+    }
+}
+
+namespace xtea {
+    void encrypt(uint8* data, size_t size, const Key& key, uint32* checksum)
+    {
+        crypt<true>(data, size, encryptKeys(key), checksum);
+    }
+
+    void decrypt(uint8* data, size_t size, const Key& key, uint32* checksum)
+    {
+        crypt<false>(data, size, decryptKeys(key), checksum);
+    }
+
+    bool selfCheck()
+    {
+        if(!checkScalar()) {
+            g_logger.error("XTEA self check failed for the scalar implementation");
+            return false;
+        }
+
+        bool ok = true;
+#ifdef XTEA_AVX2
+        if(stdext::cpu_supports_avx2() && !checkCrypt(cryptAvx2<true>, cryptAvx2<false>)) {
+            g_logger.error("XTEA self check failed for the AVX2 implementation");
+            ok = false;
+        }
+#endif
+#ifdef XTEA_SSE2
+        if(!checkCrypt(cryptSse2<true>, cryptSse2<false>)) {
+            g_logger.error("XTEA self check failed for the SSE2 implementation");
+            ok = false;
+        }
+#endif
+#ifdef XTEA_NEON
+        if(!checkCrypt(cryptNeon<true>, cryptNeon<false>)) {
+            g_logger.error("XTEA self check failed for the NEON implementation");
+            ok = false;
+        }
+#endif
+        // must be settled before the first crypt picks its implementation
+        useScalar = !ok;
+
+        if(!checkChecksum()) {
+            g_logger.error("XTEA self check failed for the fused checksum");
+            ok = false;
+        }
+        return ok;
+    }
+}
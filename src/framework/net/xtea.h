@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef XTEA_H
+#define XTEA_H
+
+#include "../stdext/types.h"
+#include <array>
+
+namespace xtea {
+    using Key = std::array<uint32, 4>;
+
+    // size must be a multiple of 8, when a checksum is given it receives the
+    // adler32 of the encrypted data, computed in the same pass over the buffer
+    void encrypt(uint8* data, size_t size, const Key& key, uint32* checksum = nullptr);
+    void decrypt(uint8* data, size_t size, const Key& key, uint32* checksum = nullptr);
+
+    // checks the scalar path and the fused checksum against known answers and every
+    // vectorized path available on this cpu against the scalar one, a vectorized path
+    // that disagrees is logged and replaced by the scalar one, must run before any crypt
+    bool selfCheck();
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "otmlcompiler.h"
+#include "otmldocument.h"
+
+namespace {
+    enum NodeFlags : uint8 {
+        NodeUnique = 1,
+        NodeNull = 2
+    };
+
+    // smallest node: flags, line, empty tag, empty value and no children
+    constexpr std::size_t MIN_NODE_SIZE = 5;
+
+    // 7 bits per byte, the high bit tells another byte follows, lengths and lines mostly take one
+    void writeU32(std::string& out, uint32 value)
+    {
+        while(value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void writeString(std::string& out, const std::string& str)
+    {
+        writeU32(out, str.size());
+        out.append(str);
+    }
+
+    // parsed nodes have the document source followed by their line, list values have none
+    bool writeNode(std::string& out, const OTMLNodePtr& node, const std::string& sourcePrefix)
+    {
+        uint32 line = 0;
+        const std::string source = node->source();
+        if(!source.empty()) {
+            if(source.compare(0, sourcePrefix.size(), sourcePrefix) != 0 || !stdext::cast(source.substr(sourcePrefix.size()), line) || line == 0)
+                return false;
+        }
+
+        out.push_back(static_cast<char>((node->isUnique() ? NodeUnique : 0) | (node->isNull() ? NodeNull : 0)));
+        writeU32(out, line);
+        writeString(out, node->tag());
+        writeString(out, node->rawValue());
+
+        const OTMLNodeList children = node->children();
+        writeU32(out, children.size());
+        for(const OTMLNodePtr& child : children) {
+            if(!writeNode(out, child, sourcePrefix))
+                return false;
+        }
+        return true;
+    }
+}
+
+class OTMLCompiler::Reader
+{
+public:
+    Reader(const std::string& data, std::size_t offset, const std::string& sourcePrefix) : sourcePrefix(sourcePrefix), m_data(data), m_pos(std::min<std::size_t>(offset, data.size())) {}
+
+    bool readU32(uint32& value)
+    {
+        value = 0;
+        for(int shift = 0; shift < 32; shift += 7) {
+            if(m_pos >= m_data.size())
+                return false;
+            const uint8 byte = m_data[m_pos++];
+            value |= static_cast<uint32>(byte & 0x7f) << shift;
+            if(!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool readByte(uint8& value)
+    {
+        if(m_pos >= m_data.size())
+            return false;
+        value = m_data[m_pos++];
+        return true;
+    }
+
+    bool readString(std::string& str)
+    {
+        uint32 size;
+        if(!readU32(size) || m_data.size() - m_pos < size)
+            return false;
+        str.assign(m_data, m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    // a corrupted count can't make us allocate more nodes than the data could hold
+    std::size_t maxNodes() const { return (m_data.size() - m_pos) / MIN_NODE_SIZE; }
+    bool atEnd() const { return m_pos == m_data.size(); }
+
+    const std::string& sourcePrefix;
+
+private:
+    const std::string& m_data;
+    std::size_t m_pos;
+};
+
+std::string OTMLCompiler::compile(const OTMLDocumentPtr& doc)
+{
+    std::string out;
+    const std::string sourcePrefix = doc->source() + ":";
+
+    const OTMLNodeList children = doc->children();
+    writeU32(out, children.size());
+    for(const OTMLNodePtr& child : children) {
+        if(!writeNode(out, child, sourcePrefix))
+            return std::string();
+    }
+    return out;
+}
+
+bool OTMLCompiler::load(const OTMLDocumentPtr& doc, const std::string& data, std::size_t offset)
+{
+    const std::string sourcePrefix = doc->source() + ":";
+    Reader reader(data, offset, sourcePrefix);
+    if(readChildren(reader, doc) && reader.atEnd())
+        return true;
+
+    doc->clear();
+    return false;
+}
+
+bool OTMLCompiler::readChildren(Reader& reader, const OTMLNodePtr& parent)
+{
+    uint32 count;
+    if(!reader.readU32(count) || count > reader.maxNodes())
+        return false;
+
+    // the children were merged when the source was parsed, they are appended as they are
+    parent->m_children.reserve(count);
+    for(uint32 i = 0; i < count; ++i) {
+        uint8 flags;
+        uint32 line;
+        std::string tag, value;
+        if(!reader.readByte(flags) || !reader.readU32(line) || !reader.readString(tag) || !reader.readString(value))
+            return false;
+
+        const OTMLNodePtr node = OTMLNode::create(tag, (flags & NodeUnique) != 0);
+        node->setValue(value);
+        node->setNull((flags & NodeNull) != 0);
+        if(line > 0)
+            node->setSource(reader.sourcePrefix + std::to_string(line));
+
+        parent->m_children.push_back(node);
+        if(!readChildren(reader, node))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef OTMLCOMPILER_H
+#define OTMLCOMPILER_H
+
+#include "declarations.h"
+
+// Binary form of parsed documents, it loads back into the same node tree without tokenizing
+// lines or going through the unique tag merging of addChild
+class OTMLCompiler
+{
+public:
+    /// Serializes the nodes of a document parsed from its source, empty when it can't be compiled
+    static std::string compile(const OTMLDocumentPtr& doc);
+    /// Rebuilds the nodes of an empty document from compile output starting at offset, false when data is malformed
+    static bool load(const OTMLDocumentPtr& doc, const std::string& data, std::size_t offset = 0);
+
+private:
+    class Reader;
+    static bool readChildren(Reader& reader, const OTMLNodePtr& parent);
+};
+
+#endif
@@ -23,9 +23,40 @@
 #include "otmldocument.h"
 #include "otmlparser.h"
 #include "otmlemitter.h"
+#include "otmlcompiler.h"
 
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/resourcemanager.h>
 
+namespace {
+    // bump when the compiled form changes
+    const std::string CACHE_VERSION = "otmlc/1";
+    const std::string CACHE_DIR = "/otml";
+
+    // module files are read at every startup and rarely change, configs change all the time
+    bool isCacheable(const std::string& source)
+    {
+        return stdext::ends_with(source, ".otui") || stdext::ends_with(source, ".otmod") || stdext::ends_with(source, ".otfont");
+    }
+
+    // cache files written by the async workers, their failures are logged from the main thread
+    std::vector<boost::shared_future<std::string>> pendingCacheWrites;
+
+    void checkCacheWrites()
+    {
+        auto it = pendingCacheWrites.begin();
+        while(it != pendingCacheWrites.end()) {
+            if(!it->is_ready()) {
+                ++it;
+                continue;
+            }
+            if(!it->get().empty())
+                g_logger.error(stdext::format("Unable to cache otml document: %s", it->get()));
+            it = pendingCacheWrites.erase(it);
+        }
+    }
+}
+
 OTMLDocumentPtr OTMLDocument::create()
 {
     OTMLDocumentPtr doc(new OTMLDocument);
@@ -35,10 +66,46 @@ OTMLDocumentPtr OTMLDocument::create()
 
 OTMLDocumentPtr OTMLDocument::parse(const std::string& fileName)
 {
-    std::stringstream fin;
     const std::string source = g_resources.resolvePath(fileName);
-    g_resources.readFileStream(source, fin);
-    return parse(fin, source);
+    const std::string buffer = g_resources.readFileContents(source);
+
+    OTMLDocumentPtr doc(new OTMLDocument);
+    doc->setSource(source);
+
+    // one file per document, its header tells which source it was compiled from
+    const bool cacheable = isCacheable(source) && !g_resources.getWriteDir().empty();
+    std::string cacheFile, key;
+    if(cacheable) {
+        checkCacheWrites();
+
+        cacheFile = stdext::format("%s/%s.otmlc", CACHE_DIR, stdext::dec_to_hex(stdext::fnv1a_hash(source)));
+        key = stdext::dec_to_hex(stdext::fnv1a_hash(buffer, stdext::fnv1a_hash(source, stdext::fnv1a_hash(CACHE_VERSION)))) + "\n";
+        if(g_resources.fileExists(cacheFile)) {
+            try {
+                const std::string cached = g_resources.readFileContents(cacheFile);
+                if(cached.compare(0, key.length(), key) == 0 && OTMLCompiler::load(doc, cached, key.length()))
+                    return doc;
+            } catch(stdext::exception&) {
+            }
+        }
+    }
+
+    OTMLParser parser(doc, buffer);
+    parser.parse();
+
+    if(cacheable) {
+        const std::string contents = key + OTMLCompiler::compile(doc);
+        if(contents.size() > key.size()) {
+            if(!g_resources.directoryExists(CACHE_DIR))
+                g_resources.makeDir(CACHE_DIR);
+            pendingCacheWrites.push_back(g_asyncDispatcher.schedule([cacheFile, contents] {
+                std::string error;
+                g_resources.writeFileBuffer(cacheFile, (const uchar*)contents.data(), contents.size(), error);
+                return error;
+            }));
+        }
+    }
+    return doc;
 }
 
 OTMLDocumentPtr OTMLDocument::parse(std::istream& in, const std::string& source)
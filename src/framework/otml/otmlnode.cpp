@@ -24,6 +24,87 @@
 #include "otmlemitter.h"
 #include "otmldocument.h"
 
+#ifdef THREAD_SAFE
+#include <mutex>
+#endif
+
+namespace {
+    // blocks are carved from chunks and recycled through a free list, chunks are never
+    // released so the pool stays at the peak node count
+    class NodePool
+    {
+    public:
+        void* allocate()
+        {
+#ifdef THREAD_SAFE
+            std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+            if(!m_free) {
+                m_chunks.emplace_back(new Block[BLOCKS_PER_CHUNK]);
+                Block* chunk = m_chunks.back().get();
+                for(int i = 0; i < BLOCKS_PER_CHUNK; ++i)
+                    chunk[i].next = i + 1 < BLOCKS_PER_CHUNK ? &chunk[i + 1] : nullptr;
+                m_free = chunk;
+            }
+
+            Block* block = m_free;
+            m_free = block->next;
+            return block;
+        }
+
+        void deallocate(void* ptr)
+        {
+#ifdef THREAD_SAFE
+            std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+            Block* block = static_cast<Block*>(ptr);
+            block->next = m_free;
+            m_free = block;
+        }
+
+    private:
+        enum { BLOCKS_PER_CHUNK = 256 };
+
+        union Block
+        {
+            Block* next;
+            alignas(OTMLNode) uint8 storage[sizeof(OTMLNode)];
+        };
+
+        Block* m_free{ nullptr };
+        std::vector<std::unique_ptr<Block[]>> m_chunks;
+#ifdef THREAD_SAFE
+        std::mutex m_mutex;
+#endif
+    };
+
+    // never destroyed, nodes held by other statics may still be released at exit
+    NodePool& nodePool()
+    {
+        static NodePool* pool = new NodePool;
+        return *pool;
+    }
+}
+
+void* OTMLNode::operator new(std::size_t size)
+{
+    // documents and other derived nodes are bigger
+    if(size != sizeof(OTMLNode))
+        return ::operator new(size);
+    return nodePool().allocate();
+}
+
+void OTMLNode::operator delete(void* ptr, std::size_t size)
+{
+    if(!ptr)
+        return;
+    if(size != sizeof(OTMLNode)) {
+        ::operator delete(ptr);
+        return;
+    }
+    nodePool().deallocate(ptr);
+}
+
 OTMLNodePtr OTMLNode::create(const std::string& tag, bool unique)
 {
     OTMLNodePtr node(new OTMLNode);
@@ -184,8 +265,11 @@ OTMLNodePtr OTMLNode::clone()
     myClone->setUnique(m_unique);
     myClone->setNull(m_null);
     myClone->setSource(m_source);
+
+    // children are already free of duplicated unique tags, so there is no need to check them again
+    myClone->m_children.reserve(m_children.size());
     for(const OTMLNodePtr& child : m_children)
-        myClone->addChild(child->clone());
+        myClone->m_children.push_back(child->clone());
     return myClone;
 }
 
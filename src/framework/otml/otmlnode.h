@@ -91,9 +91,15 @@ public:
 
     OTMLNodePtr asOTMLNode() { return static_self_cast<OTMLNode>(); }
 
+    // nodes are created by the thousands when documents load, they come from a pool of fixed size blocks
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+
 protected:
     OTMLNode() = default;
 
+    friend class OTMLCompiler;
+
     OTMLNodeList m_children;
     std::string m_tag;
     std::string m_value;
@@ -25,35 +25,68 @@
 #include "otmlexception.h"
 #include <boost/tokenizer.hpp>
 
+namespace {
+    // same characters boost::trim strips with the classic locale
+    std::string_view trimmed(std::string_view str)
+    {
+        constexpr const char* spaces = " \t\r\n\v\f";
+        const std::size_t first = str.find_first_not_of(spaces);
+        if(first == std::string_view::npos)
+            return std::string_view();
+        return str.substr(first, str.find_last_not_of(spaces) - first + 1);
+    }
+}
+
 OTMLParser::OTMLParser(const OTMLDocumentPtr& doc, std::istream& in) :
     currentDepth(0), currentLine(0),
-    doc(doc), currentParent(doc), previousNode(nullptr),
-    in(in)
+    doc(doc), previousNode(nullptr),
+    pos(0), readable(in.good()), eof(false)
+{
+    streamBuffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    buffer = streamBuffer;
+}
+
+OTMLParser::OTMLParser(const OTMLDocumentPtr& doc, const std::string& buffer) :
+    currentDepth(0), currentLine(0),
+    doc(doc), previousNode(nullptr),
+    buffer(buffer), pos(0), readable(true), eof(false)
 {
 }
 
 void OTMLParser::parse()
 {
-    if(!in.good())
+    if(!readable)
         throw OTMLException(doc, "cannot read from input stream");
 
-    while(!in.eof())
+    parents.assign(1, doc);
+    sourcePrefix = doc->source() + ":";
+    while(!eof)
         parseLine(getNextLine());
 }
 
-std::string OTMLParser::getNextLine()
+std::string_view OTMLParser::getNextLine()
 {
     currentLine++;
-    std::string line;
-    std::getline(in, line);
+
+    // the text after the last line break is a line too, like std::getline would read it
+    const std::size_t end = buffer.find('\n', pos);
+    if(end == std::string_view::npos) {
+        const std::string_view line = buffer.substr(pos);
+        pos = buffer.size();
+        eof = true;
+        return line;
+    }
+
+    const std::string_view line = buffer.substr(pos, end - pos);
+    pos = end + 1;
     return line;
 }
 
-int OTMLParser::getLineDepth(const std::string& line, bool multilining)
+int OTMLParser::getLineDepth(std::string_view line, bool multilining)
 {
     // count number of spaces at the line beginning
     std::size_t spaces = 0;
-    while(line[spaces] == ' ')
+    while(spaces < line.size() && line[spaces] == ' ')
         spaces++;
 
     // pre calculate depth
@@ -61,7 +94,7 @@ int OTMLParser::getLineDepth(const std::string& line, bool multilining)
 
     if(!multilining || depth <= currentDepth) {
         // check the next character is a tab
-        if(line[spaces] == '\t')
+        if(spaces < line.size() && line[spaces] == '\t')
             throw OTMLException(doc, "indentation with tabs are not allowed", currentLine);
 
         // must indent every 2 spaces
@@ -72,31 +105,27 @@ int OTMLParser::getLineDepth(const std::string& line, bool multilining)
     return depth;
 }
 
-void OTMLParser::parseLine(std::string line)
+void OTMLParser::parseLine(std::string_view line)
 {
     const int depth = getLineDepth(line);
 
-    if(depth == -1)
-        return;
-
     // remove line sides spaces
-    stdext::trim(line);
+    line = trimmed(line);
 
     // skip empty lines
     if(line.empty())
         return;
 
     // skip comments
-    if(stdext::starts_with(line, "//"))
+    if(line.compare(0, 2, "//") == 0)
         return;
 
     // a depth above, change current parent to the previous added node
-    if(depth == currentDepth + 1) {
-        currentParent = previousNode;
+    if(depth == currentDepth + 1 && previousNode) {
+        parents.push_back(previousNode);
         // a depth below, change parent to previous parent
     } else if(depth < currentDepth) {
-        for(int i = 0; i < currentDepth - depth; ++i)
-            currentParent = parentMap[currentParent];
+        parents.resize(parents.size() - (currentDepth - depth));
         // if it isn't the current depth, it's a syntax error
     } else if(depth != currentDepth)
         throw OTMLException(doc, "invalid indentation depth, are you indenting correctly?", currentLine);
@@ -109,38 +138,37 @@ void OTMLParser::parseLine(std::string line)
     parseNode(line);
 }
 
-void OTMLParser::parseNode(const std::string& data)
+void OTMLParser::parseNode(std::string_view data)
 {
-    std::string tag;
-    std::string value;
-    std::size_t dotsPos = data.find_first_of(':');
-    int nodeLine = currentLine;
+    std::string_view tag;
+    std::string_view value;
+    const std::size_t dotsPos = data.find(':');
+    const int nodeLine = currentLine;
 
     // node that has no tag and may have a value
     if(!data.empty() && data[0] == '-') {
         value = data.substr(1);
-        stdext::trim(value);
         // node that has tag and possible a value
-    } else if(dotsPos != std::string::npos) {
+    } else if(dotsPos != std::string_view::npos) {
         tag = data.substr(0, dotsPos);
-        if(data.size() > dotsPos + 1)
-            value = data.substr(dotsPos + 1);
+        value = data.substr(dotsPos + 1);
         // node that has only a tag
     } else {
         tag = data;
     }
 
-    stdext::trim(tag);
-    stdext::trim(value);
+    tag = trimmed(tag);
+    value = trimmed(value);
+
+    std::string multiLineData;
 
     // process multitine values
     if(value == "|" || value == "|-" || value == "|+") {
         // reads next lines until we can a value below the same depth
-        std::string multiLineData;
         do {
-            size_t lastPos = in.tellg();
-            std::string line = getNextLine();
-            int depth = getLineDepth(line, true);
+            const std::size_t lastPos = pos;
+            const std::string_view line = getNextLine();
+            const int depth = getLineDepth(line, true);
 
             // depth above current depth, add the text to the multiline
             if(depth > currentDepth) {
@@ -148,16 +176,16 @@ void OTMLParser::parseNode(const std::string& data)
                 // it has contents below the current depth
             } else {
                 // if not empty, its a node
-                stdext::trim(line);
-                if(!line.empty()) {
+                if(!trimmed(line).empty()) {
                     // rewind and break
-                    in.seekg(lastPos, std::ios::beg);
+                    pos = lastPos;
+                    eof = false;
                     currentLine--;
                     break;
                 }
             }
             multiLineData += "\n";
-        } while(!in.eof());
+        } while(!eof);
 
         /* determine how to treat new lines at the end
          * | strip all new lines at the end and add just a new one
@@ -166,9 +194,8 @@ void OTMLParser::parseNode(const std::string& data)
          */
         if(value == "|" || value == "|-") {
             // remove all new lines at the end
-            int lastPos = multiLineData.length();
-            while(multiLineData[--lastPos] == '\n')
-                multiLineData.erase(lastPos, 1);
+            const std::size_t lastPos = multiLineData.find_last_not_of('\n');
+            multiLineData.erase(lastPos == std::string::npos ? 0 : lastPos + 1);
 
             if(value == "|")
                 multiLineData.append("\n");
@@ -178,28 +205,26 @@ void OTMLParser::parseNode(const std::string& data)
     }
 
     // create the node
-    OTMLNodePtr node = OTMLNode::create(tag);
+    OTMLNodePtr node = OTMLNode::create(std::string(tag));
 
-    node->setUnique(dotsPos != std::string::npos);
-    node->setTag(tag);
-    node->setSource(doc->source() + ":" + stdext::unsafe_cast<std::string>(nodeLine));
+    node->setUnique(dotsPos != std::string_view::npos);
+    node->setSource(sourcePrefix + std::to_string(nodeLine));
 
     // ~ is considered the null value
     if(value == "~")
         node->setNull(true);
     else {
-        if(stdext::starts_with(value, "[") && stdext::ends_with(value, "]")) {
-            std::string tmp = value.substr(1, value.length() - 2);
+        if(!value.empty() && value.front() == '[' && value.back() == ']') {
+            const std::string tmp(value.substr(1, value.length() - 2));
             boost::tokenizer<boost::escaped_list_separator<char>> tokens(tmp);
             for(std::string v : tokens) {
                 stdext::trim(v);
                 node->writeIn(v);
             }
         } else
-            node->setValue(value);
+            node->setValue(std::string(value));
     }
 
-    currentParent->addChild(node);
-    parentMap[node] = currentParent;
+    parents.back()->addChild(node);
     previousNode = node;
 }
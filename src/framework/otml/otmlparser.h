@@ -29,28 +29,34 @@ class OTMLParser
 {
 public:
     OTMLParser(const OTMLDocumentPtr& doc, std::istream& in);
+    /// Parse straight from an in memory buffer, which must outlive the parser, an empty buffer is an empty document
+    OTMLParser(const OTMLDocumentPtr& doc, const std::string& buffer);
 
     /// Parse the entire document
     void parse();
 
 private:
-    /// Retrieve next line from the input stream
-    std::string getNextLine();
+    /// Retrieve next line from the buffer, without copying it
+    std::string_view getNextLine();
     /// Counts depth of a line (every 2 spaces increments one depth)
-    int getLineDepth(const std::string& line, bool multilining = false);
+    int getLineDepth(std::string_view line, bool multilining = false);
 
-    /// Parse each line of the input stream
-    void parseLine(std::string line);
+    /// Parse each line of the buffer
+    void parseLine(std::string_view line);
     /// Parse nodes tag and value
-    void parseNode(const std::string& data);
+    void parseNode(std::string_view data);
 
     int currentDepth;
     int currentLine;
     OTMLDocumentPtr doc;
-    OTMLNodePtr currentParent;
-    std::unordered_map<OTMLNodePtr, OTMLNodePtr> parentMap;
+    std::vector<OTMLNodePtr> parents; // the current parent is the last one
     OTMLNodePtr previousNode;
-    std::istream& in;
+    std::string sourcePrefix;
+    std::string streamBuffer;
+    std::string_view buffer;
+    std::size_t pos;
+    bool readable;
+    bool eof;
 };
 
 #endif
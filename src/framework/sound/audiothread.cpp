@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "audiothread.h"
+#include "soundbuffer.h"
+#include "soundfile.h"
+
+AudioThread g_audio;
+
+void AudioThread::init()
+{
+    m_mainThreadId = std::this_thread::get_id();
+    m_running = true;
+    m_thread = std::thread([this] {
+        while(m_running) {
+            try {
+                update();
+            } catch(std::exception& e) {
+                log(stdext::format("Audio thread exception: %s", e.what()));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(UPDATE_DELAY));
+        }
+    });
+}
+
+void AudioThread::terminate()
+{
+    m_running = false;
+    if(m_thread.joinable())
+        m_thread.join();
+
+    // sources released while shutting down are freed here, the context is still current
+    Command command;
+    while(m_commands.pop(command))
+        execute(command);
+
+    // streams still referenced elsewhere go silent, they are freed along with their sources
+    for(Stream* stream : m_streams)
+        stopStream(stream);
+
+    poll();
+}
+
+void AudioThread::poll()
+{
+    std::string* message;
+    while(m_messages.pop(message)) {
+        g_logger.error(*message);
+        delete message;
+    }
+}
+
+void AudioThread::post(CommandType type, Stream* stream, int value)
+{
+    push({ type, stream, nullptr, value });
+}
+
+void AudioThread::post(Stream* stream, const SoundFilePtr& soundFile)
+{
+    // the reference is adopted by the stream in the audio thread
+    soundFile->add_ref();
+    push({ SetSoundFile, stream, soundFile.get(), 0 });
+}
+
+void AudioThread::push(const Command& command)
+{
+    // without the thread (no audio device, or after terminate) commands run right away
+    if(!m_running) {
+        execute(command);
+        return;
+    }
+
+    while(!m_commands.push(command))
+        std::this_thread::yield();
+}
+
+void AudioThread::log(const std::string& message)
+{
+    // commands run inline in the main thread once the thread is gone
+    if(std::this_thread::get_id() == m_mainThreadId) {
+        g_logger.error(message);
+        return;
+    }
+
+    // dropped when the main thread is too far behind, the queue is full of errors anyway
+    auto entry = new std::string(message);
+    if(!m_messages.push(entry))
+        delete entry;
+}
+
+void AudioThread::execute(const Command& command)
+{
+    Stream* stream = command.stream;
+    switch(command.type) {
+    case AddStream:
+        m_streams.push_back(stream);
+        break;
+    case ReleaseStream:
+        stopStream(stream);
+        alDeleteSources(1, &stream->sourceId);
+        m_streams.erase(std::find(m_streams.begin(), m_streams.end(), stream));
+        delete stream;
+        break;
+    case SetSoundFile:
+        stream->soundFile = SoundFilePtr(command.soundFile, false);
+        stream->eof = false;
+        if(stream->playing)
+            startStream(stream);
+        break;
+    case SetDownMix:
+        stream->downMixChannel = command.value;
+        break;
+    case PlayStream:
+        stream->serial = command.value;
+        stream->playing = true;
+        if(stream->soundFile)
+            startStream(stream);
+        break;
+    case StopStream:
+        stopStream(stream);
+        break;
+    }
+}
+
+void AudioThread::update()
+{
+    Command command;
+    while(m_commands.pop(command))
+        execute(command);
+
+    for(Stream* stream : m_streams)
+        updateStream(stream);
+}
+
+void AudioThread::updateStream(Stream* stream)
+{
+    if(!stream->playing || !stream->soundFile)
+        return;
+
+    // refill the fragments already played
+    int processed = 0;
+    alGetSourcei(stream->sourceId, AL_BUFFERS_PROCESSED, &processed);
+    for(int i = 0; i < processed; ++i) {
+        uint buffer;
+        alSourceUnqueueBuffers(stream->sourceId, 1, &buffer);
+        if(!stream->eof)
+            fillBufferAndQueue(stream, buffer);
+    }
+
+    int state = AL_PLAYING;
+    alGetSourcei(stream->sourceId, AL_SOURCE_STATE, &state);
+    if(state != AL_STOPPED)
+        return;
+
+    int queued = 0;
+    alGetSourcei(stream->sourceId, AL_BUFFERS_QUEUED, &queued);
+    if(queued > 0) {
+        log("audio buffer underrun");
+        alSourcePlay(stream->sourceId);
+    } else if(stream->looping) {
+        startStream(stream);
+    } else {
+        stopStream(stream);
+        stream->finished = stream->serial;
+    }
+}
+
+void AudioThread::startStream(Stream* stream)
+{
+    // drop whatever is left of the previous playback
+    alSourceStop(stream->sourceId);
+    alSourcei(stream->sourceId, AL_BUFFER, AL_NONE);
+
+    if(stream->eof) {
+        stream->soundFile->reset();
+        stream->eof = false;
+    }
+
+    for(const SoundBufferPtr& buffer : stream->buffers) {
+        if(stream->eof)
+            break;
+        fillBufferAndQueue(stream, buffer->getBufferId());
+    }
+
+    alSourcePlay(stream->sourceId);
+}
+
+void AudioThread::stopStream(Stream* stream)
+{
+    stream->playing = false;
+    alSourceStop(stream->sourceId);
+    alSourcei(stream->sourceId, AL_BUFFER, AL_NONE);
+}
+
+void AudioThread::fillBufferAndQueue(Stream* stream, uint buffer)
+{
+    const SoundFilePtr& soundFile = stream->soundFile;
+    ALenum format = soundFile->getSampleFormat();
+
+    int maxRead = STREAM_FRAGMENT_SIZE;
+    if(stream->downMixChannel >= 0)
+        maxRead *= 2;
+
+    int bytesRead = 0;
+    do {
+        bytesRead += soundFile->read(&m_bufferData[bytesRead], maxRead - bytesRead);
+
+        // end of sound file
+        if(bytesRead < maxRead) {
+            if(stream->looping)
+                soundFile->reset();
+            else {
+                stream->eof = true;
+                break;
+            }
+        }
+    } while(bytesRead < maxRead);
+
+    if(bytesRead <= 0)
+        return;
+
+    if(stream->downMixChannel >= 0 && format == AL_FORMAT_STEREO16) {
+        assert(bytesRead % 2 == 0);
+        bytesRead /= 2;
+        auto data = (uint16_t*)m_bufferData.data();
+        for(int i = 0; i < bytesRead / 2; i++)
+            data[i] = data[2 * i + stream->downMixChannel];
+        format = AL_FORMAT_MONO16;
+    }
+
+    alBufferData(buffer, format, &m_bufferData[0], bytesRead, soundFile->getRate());
+    ALenum err = alGetError();
+    if(err != AL_NO_ERROR)
+        log(stdext::format("unable to refill audio buffer for '%s': %s", soundFile->getName(), alGetString(err)));
+
+    alSourceQueueBuffers(stream->sourceId, 1, &buffer);
+    err = alGetError();
+    if(err != AL_NO_ERROR)
+        log(stdext::format("unable to queue audio buffer for '%s': %s", soundFile->getName(), alGetString(err)));
+}
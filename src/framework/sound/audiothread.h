@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef AUDIOTHREAD_H
+#define AUDIOTHREAD_H
+
+#include "declarations.h"
+#include <framework/util/databuffer.h>
+
+#include <atomic>
+#include <thread>
+#include <boost/lockfree/spsc_queue.hpp>
+
+/// Streams sound files in a dedicated thread. Every stream decodes straight into the
+/// OpenAL buffer queue of its source, which the thread keeps topped up (and restarts
+/// after an underrun), so neither ogg decoding nor a slow frame touches playback.
+/// The main thread only issues commands through a lock-free queue, gain, pitch and
+/// position are still set on the source itself.
+class AudioThread
+{
+    enum {
+        COMMAND_QUEUE_SIZE = 1024,
+        MESSAGE_QUEUE_SIZE = 256,
+        UPDATE_DELAY = 10
+    };
+
+public:
+    enum {
+        STREAM_BUFFER_SIZE = 1024 * 400,
+        STREAM_FRAGMENTS = 4,
+        STREAM_FRAGMENT_SIZE = STREAM_BUFFER_SIZE / STREAM_FRAGMENTS
+    };
+
+    enum CommandType { AddStream, ReleaseStream, SetSoundFile, SetDownMix, PlayStream, StopStream };
+
+    /// State of a streaming source, only touched by the audio thread once added
+    struct Stream {
+        uint sourceId{ 0 };
+        SoundFilePtr soundFile;
+        std::array<SoundBufferPtr, STREAM_FRAGMENTS> buffers;
+        int downMixChannel{ -1 };
+        uint serial{ 0 };
+        bool playing{ false },
+            looping{ false },
+            eof{ false };
+        /// Serial of the last play command that ran to the end, read by the main thread
+        std::atomic<uint> finished{ 0 };
+    };
+
+    struct Command {
+        CommandType type;
+        Stream* stream;
+        SoundFile* soundFile;
+        int value;
+    };
+
+    void init();
+    void terminate();
+
+    /// Logs the messages left by the audio thread, main thread only
+    void poll();
+
+    /// Queues a command for the audio thread, main thread only
+    void post(CommandType type, Stream* stream, int value = 0);
+    /// Hands a sound file to a stream, main thread only
+    void post(Stream* stream, const SoundFilePtr& soundFile);
+
+private:
+    void push(const Command& command);
+    void log(const std::string& message);
+    void execute(const Command& command);
+    void update();
+    void updateStream(Stream* stream);
+    void startStream(Stream* stream);
+    void stopStream(Stream* stream);
+    void fillBufferAndQueue(Stream* stream, uint buffer);
+
+    std::thread m_thread;
+    std::thread::id m_mainThreadId;
+    std::atomic<bool> m_running{ false };
+    std::vector<Stream*> m_streams;
+    DataBuffer<char> m_bufferData{ 2 * STREAM_FRAGMENT_SIZE };
+
+    // main thread -> audio thread
+    boost::lockfree::spsc_queue<Command, boost::lockfree::capacity<COMMAND_QUEUE_SIZE>> m_commands;
+
+    // audio thread -> main thread, the logger may run lua code
+    boost::lockfree::spsc_queue<std::string*, boost::lockfree::capacity<MESSAGE_QUEUE_SIZE>> m_messages;
+};
+
+extern AudioThread g_audio;
+
+#endif
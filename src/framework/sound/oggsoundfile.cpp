@@ -38,10 +38,8 @@ bool OggSoundFile::prepareOgg()
     ov_open_callbacks(m_file.get(), &m_vorbisFile, nullptr, 0, callbacks);
 
     vorbis_info* vi = ov_info(&m_vorbisFile, -1);
-    if(!vi) {
-        g_logger.error(stdext::format("ogg file not supported: %s", m_file->name()));
+    if(!vi)
         return false;
-    }
 
     m_channels = vi->channels;
     m_rate = vi->rate;
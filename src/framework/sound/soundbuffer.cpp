@@ -51,7 +51,7 @@ bool SoundBuffer::fillBuffer(const SoundFilePtr& soundFile)
         return false;
     }
 
-    return fillBuffer(format, samples, samples.size(), soundFile->getRate());
+    return fillBuffer(format, samples, read, soundFile->getRate());
 }
 
 bool SoundBuffer::fillBuffer(ALenum sampleFormat, const DataBuffer<char>& data, int size, int rate)
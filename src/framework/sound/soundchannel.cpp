@@ -33,7 +33,9 @@ SoundSourcePtr SoundChannel::play(const std::string& filename, float fadetime, f
     if(m_currentSource)
         m_currentSource->stop();
 
-    m_currentSource = g_sounds.play(filename, fadetime, m_gain * gain);
+    m_currentSource = g_sounds.play(filename, fadetime, m_gain * gain, m_priority);
+    if(m_currentSource)
+        m_currentSource->setChannel(m_id);
     return m_currentSource;
 }
 
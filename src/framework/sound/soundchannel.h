@@ -45,6 +45,10 @@ public:
 
     int getId() { return m_id; }
 
+    /// Voices of channels with a higher priority are not stolen by this one
+    void setPriority(int priority) { m_priority = priority; }
+    int getPriority() { return m_priority; }
+
 protected:
     void update();
     friend class SoundManager;
@@ -60,6 +64,8 @@ private:
     bool m_enabled{ true };
     int m_id;
     float m_gain;
+    // above sounds played without a channel, so music and ambient outlast spell effects
+    int m_priority{ 1 };
 };
 
 #endif
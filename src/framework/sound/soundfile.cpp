@@ -48,8 +48,9 @@ SoundFilePtr SoundFile::loadSoundFile(const std::string& filename)
     SoundFilePtr soundFile;
     if(strncmp(magic, "OggS", 4) == 0) {
         auto oggSoundFile = OggSoundFilePtr(new OggSoundFile(file));
-        if(oggSoundFile->prepareOgg())
-            soundFile = oggSoundFile;
+        if(!oggSoundFile->prepareOgg())
+            stdext::throw_exception(stdext::format("ogg file not supported: %s", filename));
+        soundFile = oggSoundFile;
     } else
         stdext::throw_exception(stdext::format("unknown sound file format %s", filename));
 
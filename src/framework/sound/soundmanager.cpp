@@ -26,6 +26,7 @@
 #include "soundfile.h"
 #include "streamsoundsource.h"
 #include "combinedsoundsource.h"
+#include "audiothread.h"
 
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
@@ -51,7 +52,10 @@ void SoundManager::init()
 
     if(alcMakeContextCurrent(m_context) != ALC_TRUE) {
         g_logger.error(stdext::format("unable to make context current: %s", alcGetString(m_device, alcGetError(m_device))));
+        return;
     }
+
+    g_audio.init();
 }
 
 void SoundManager::terminate()
@@ -64,10 +68,19 @@ void SoundManager::terminate()
     }
     m_streamFiles.clear();
 
+    for(auto& pendingBuffer : m_pendingBuffers)
+        pendingBuffer.second.wait();
+    m_pendingBuffers.clear();
+
     m_sources.clear();
     m_buffers.clear();
+    m_buffersLru.clear();
+    m_streamedFiles.clear();
+    m_cacheSize = 0;
     m_channels.clear();
 
+    g_audio.terminate();
+
     m_audioEnabled = false;
 
     alcMakeContextCurrent(nullptr);
@@ -100,9 +113,11 @@ void SoundManager::poll()
         auto& future = it->second;
 
         if(future.is_ready()) {
-            SoundFilePtr sound = future.get();
-            if(sound)
-                source->setSoundFile(sound);
+            const auto& loaded = future.get();
+            if(!loaded.error.empty())
+                g_logger.error(loaded.error);
+            if(loaded.result)
+                source->setSoundFile(loaded.result);
             else
                 source->stop();
             it = m_streamFiles.erase(it);
@@ -111,6 +126,18 @@ void SoundManager::poll()
         }
     }
 
+    for(auto it = m_pendingBuffers.begin(); it != m_pendingBuffers.end();) {
+        if(it->second.is_ready()) {
+            const auto& decoded = it->second.get();
+            if(!decoded.error.empty())
+                g_logger.error(decoded.error);
+            cacheSound(it->first, decoded.result);
+            it = m_pendingBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
     for(auto it = m_sources.begin(); it != m_sources.end();) {
         SoundSourcePtr source = *it;
 
@@ -126,6 +153,8 @@ void SoundManager::poll()
         it.second->update();
     }
 
+    g_audio.poll();
+
     if(m_context) {
         alcProcessContext(m_context);
     }
@@ -149,29 +178,33 @@ void SoundManager::preload(std::string filename)
 {
     filename = resolveSoundFile(filename);
 
-    const auto it = m_buffers.find(filename);
-    if(it != m_buffers.end())
+    const ResourceId id = g_resources.getResourceId(filename);
+    if(m_buffers.find(id) != m_buffers.end() || m_streamedFiles.find(id) != m_streamedFiles.end())
         return;
 
     ensureContext();
-    SoundFilePtr soundFile = SoundFile::loadSoundFile(filename);
-
-    // only keep small files
-    if(!soundFile || soundFile->getSize() > MAX_CACHE_SIZE)
-        return;
-
-    auto buffer = SoundBufferPtr(new SoundBuffer);
-    if(buffer->fillBuffer(soundFile))
-        m_buffers[filename] = buffer;
+    try {
+        cacheSound(id, decodeSound(filename));
+    } catch(std::exception& e) {
+        g_logger.error(e.what());
+        cacheSound(id, nullptr);
+    }
 }
 
-SoundSourcePtr SoundManager::play(std::string filename, float fadetime, float gain)
+SoundSourcePtr SoundManager::play(std::string filename, float fadetime, float gain, int priority)
 {
     if(!m_audioEnabled)
         return nullptr;
 
     ensureContext();
 
+    // the voice is only taken over once the new source exists
+    SoundSourcePtr victim;
+    if(!findVoice(priority, victim)) {
+        ++m_rejectedVoices;
+        return nullptr;
+    }
+
     if(gain == 0)
         gain = 1.0f;
 
@@ -182,7 +215,14 @@ SoundSourcePtr SoundManager::play(std::string filename, float fadetime, float ga
         return nullptr;
     }
 
+    if(victim) {
+        victim->stop();
+        m_sources.erase(std::find(m_sources.begin(), m_sources.end(), victim));
+        ++m_stolenVoices;
+    }
+
     soundSource->setName(filename);
+    soundSource->setPriority(priority);
     soundSource->setRelative(true);
     soundSource->setGain(gain);
 
@@ -221,11 +261,22 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& filename)
     SoundSourcePtr source;
 
     try {
-        const auto it = m_buffers.find(filename);
+        const ResourceId id = g_resources.getResourceId(filename);
+        const auto it = m_buffers.find(id);
         if(it != m_buffers.end()) {
+            ++m_cacheHits;
+            m_buffersLru.splice(m_buffersLru.begin(), m_buffersLru, it->second.lru);
             source = SoundSourcePtr(new SoundSource);
-            source->setBuffer(it->second);
+            source->setBuffer(it->second.buffer);
         } else {
+            // small files are decoded in the background for the next time, this one streams
+            if(m_streamedFiles.find(id) == m_streamedFiles.end()) {
+                ++m_cacheMisses;
+                if(m_pendingBuffers.find(id) == m_pendingBuffers.end()) {
+                    m_pendingBuffers[id] = loadAsync([=] { return decodeSound(filename); });
+                }
+            }
+
 #if defined __linux && !defined OPENGL_ES
             // due to OpenAL implementation bug, stereo buffers are always downmixed to mono on linux systems
             // this is hack to work around the issue
@@ -238,41 +289,19 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& filename)
             streamSource->setRelative(true);
             streamSource->setPosition(Point(-128, 0));
             combinedSource->addSource(streamSource);
-            m_streamFiles[streamSource] = g_asyncDispatcher.schedule([=]() -> SoundFilePtr {
-                stdext::timer a;
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch(std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
+            m_streamFiles[streamSource] = loadAsync([=] { return SoundFile::loadSoundFile(filename); });
 
             streamSource = StreamSoundSourcePtr(new StreamSoundSource);
             streamSource->downMix(StreamSoundSource::DownMixRight);
             streamSource->setRelative(true);
             streamSource->setPosition(Point(128, 0));
             combinedSource->addSource(streamSource);
-            m_streamFiles[streamSource] = g_asyncDispatcher.schedule([=]() -> SoundFilePtr {
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch(std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
+            m_streamFiles[streamSource] = loadAsync([=] { return SoundFile::loadSoundFile(filename); });
 
             source = combinedSource;
 #else
             const StreamSoundSourcePtr streamSource(new StreamSoundSource);
-            m_streamFiles[streamSource] = g_asyncDispatcher.schedule([=]() -> SoundFilePtr {
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch(std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
+            m_streamFiles[streamSource] = loadAsync([=] { return SoundFile::loadSoundFile(filename); });
             source = streamSource;
 #endif
         }
@@ -284,6 +313,111 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& filename)
     return source;
 }
 
+void SoundManager::setCacheBudget(int bytes)
+{
+    m_cacheBudget = std::max<int>(bytes, 0);
+    evictBuffers();
+}
+
+float SoundManager::getCacheHitRate()
+{
+    const uint lookups = m_cacheHits + m_cacheMisses;
+    return lookups > 0 ? m_cacheHits / static_cast<float>(lookups) : 0;
+}
+
+bool SoundManager::findVoice(int priority, SoundSourcePtr& victim)
+{
+    for(auto it = m_sources.begin(); it != m_sources.end();) {
+        if(!(*it)->isPlaying())
+            it = m_sources.erase(it);
+        else
+            ++it;
+    }
+
+    if(static_cast<int>(m_sources.size()) < m_maxVoices)
+        return true;
+
+    // sources are kept in play order, so the first one found is the oldest, channel
+    // sources (music, ambient) give way to higher priorities only and are taken last
+    for(const SoundSourcePtr& source : m_sources) {
+        const int sourcePriority = source->getPriority();
+        const bool owned = source->getChannel() != 0;
+        if(sourcePriority > priority || (sourcePriority == priority && owned))
+            continue;
+        if(!victim || sourcePriority < victim->getPriority() || (sourcePriority == victim->getPriority() && !owned && victim->getChannel() != 0))
+            victim = source;
+    }
+    return victim != nullptr;
+}
+
+void SoundManager::cacheSound(ResourceId id, const DecodedSoundPtr& sound)
+{
+    // files too big (or broken) are streamed from now on
+    if(!sound) {
+        m_streamedFiles.insert(id);
+        return;
+    }
+
+    if(m_buffers.find(id) != m_buffers.end())
+        return;
+
+    const SoundBufferPtr buffer(new SoundBuffer);
+    if(!buffer->fillBuffer(sound->format, sound->samples, sound->samples.size(), sound->rate))
+        return;
+
+    m_buffersLru.push_front(id);
+    m_buffers[id] = CachedBuffer{ buffer, static_cast<int>(sound->samples.size()), m_buffersLru.begin() };
+    m_cacheSize += sound->samples.size();
+    evictBuffers();
+}
+
+void SoundManager::evictBuffers()
+{
+    // sources still playing an evicted buffer keep it alive
+    while(m_cacheSize > m_cacheBudget && !m_buffersLru.empty()) {
+        const auto it = m_buffers.find(m_buffersLru.back());
+        m_cacheSize -= it->second.size;
+        m_buffers.erase(it);
+        m_buffersLru.pop_back();
+    }
+}
+
+SoundManager::DecodedSoundPtr SoundManager::decodeSound(const std::string& filename)
+{
+    const SoundFilePtr soundFile = SoundFile::loadSoundFile(filename);
+    if(!soundFile || soundFile->getSize() > MAX_CACHE_SIZE)
+        return nullptr;
+
+    const ALenum format = soundFile->getSampleFormat();
+    if(format == AL_UNDETERMINED) {
+        stdext::throw_exception(stdext::format("unable to determine sample format for '%s'", soundFile->getName()));
+    }
+
+    auto sound = std::make_shared<DecodedSound>();
+    sound->format = format;
+    sound->rate = soundFile->getRate();
+    sound->samples.resize(soundFile->getSize());
+    const int read = soundFile->read(&sound->samples[0], soundFile->getSize());
+    if(read <= 0)
+        stdext::throw_exception(stdext::format("unable to decode '%s'", soundFile->getName()));
+    sound->samples.resize(read);
+    return sound;
+}
+
+template<typename F>
+boost::shared_future<SoundManager::AsyncLoad<typename std::result_of<F()>::type>> SoundManager::loadAsync(const F& load)
+{
+    // runs on a worker, the logger isn't safe there so failures are handed back to poll
+    using Result = AsyncLoad<typename std::result_of<F()>::type>;
+    return g_asyncDispatcher.schedule([=]() -> Result {
+        try {
+            return Result{ load(), std::string() };
+        } catch(std::exception& e) {
+            return Result{ nullptr, e.what() };
+        }
+    });
+}
+
 std::string SoundManager::resolveSoundFile(std::string file)
 {
     file = g_resources.guessFilePath(file, "ogg");
@@ -25,12 +25,18 @@
 
 #include "declarations.h"
 #include "soundchannel.h"
+#include <framework/core/declarations.h>
+#include <framework/util/databuffer.h>
+
+#include <unordered_set>
 
  //@bindsingleton g_sounds
 class SoundManager
 {
     enum {
         MAX_CACHE_SIZE = 100000,
+        CACHE_BUDGET = 8 * 1024 * 1024,
+        MAX_VOICES = 32,
         POLL_DELAY = 100
     };
 public:
@@ -45,21 +51,73 @@ public:
     void stopAll();
 
     void preload(std::string filename);
-    SoundSourcePtr play(std::string filename, float fadetime = 0, float gain = 0);
+    /// When all voices are busy the oldest one of the lowest priority is stolen,
+    /// nothing plays if every voice has a higher priority
+    SoundSourcePtr play(std::string filename, float fadetime = 0, float gain = 0, int priority = 0);
     SoundChannelPtr getChannel(int channel);
 
+    /// Bytes of decoded samples kept, least recently played sounds are dropped first
+    void setCacheBudget(int bytes);
+    int getCacheBudget() { return m_cacheBudget; }
+    int getCacheSize() { return m_cacheSize; }
+    float getCacheHitRate();
+
+    void setMaxVoices(int voices) { m_maxVoices = std::max<int>(voices, 1); }
+    int getMaxVoices() { return m_maxVoices; }
+    int getActiveVoices() { return m_sources.size(); }
+    int getStolenVoices() { return m_stolenVoices; }
+    int getRejectedVoices() { return m_rejectedVoices; }
+
     std::string resolveSoundFile(std::string file);
     void ensureContext();
 
 private:
+    struct DecodedSound {
+        ALenum format;
+        int rate;
+        DataBuffer<char> samples;
+    };
+    using DecodedSoundPtr = std::shared_ptr<DecodedSound>;
+
+    /// Result of a background load, its error is logged by poll on the main thread
+    template<typename T>
+    struct AsyncLoad {
+        T result;
+        std::string error;
+    };
+
+    struct CachedBuffer {
+        SoundBufferPtr buffer;
+        int size;
+        std::list<ResourceId>::iterator lru;
+    };
+
     SoundSourcePtr createSoundSource(const std::string& filename);
+    /// False when all voices are taken by higher priorities, victim is the voice to steal (if any)
+    bool findVoice(int priority, SoundSourcePtr& victim);
+    void cacheSound(ResourceId id, const DecodedSoundPtr& sound);
+    void evictBuffers();
+    static DecodedSoundPtr decodeSound(const std::string& filename);
+    template<typename F>
+    static boost::shared_future<AsyncLoad<typename std::result_of<F()>::type>> loadAsync(const F& load);
 
     ALCdevice* m_device;
     ALCcontext* m_context;
 
-    std::map<StreamSoundSourcePtr, boost::shared_future<SoundFilePtr>> m_streamFiles;
-    std::unordered_map<std::string, SoundBufferPtr> m_buffers;
+    std::map<StreamSoundSourcePtr, boost::shared_future<AsyncLoad<SoundFilePtr>>> m_streamFiles;
+    std::unordered_map<ResourceId, CachedBuffer> m_buffers;
+    std::list<ResourceId> m_buffersLru;
+    std::unordered_map<ResourceId, boost::shared_future<AsyncLoad<DecodedSoundPtr>>> m_pendingBuffers;
+    std::unordered_set<ResourceId> m_streamedFiles;
+    int m_cacheBudget{ CACHE_BUDGET };
+    int m_cacheSize{ 0 };
+    uint m_cacheHits{ 0 };
+    uint m_cacheMisses{ 0 };
+
     std::vector<SoundSourcePtr> m_sources;
+    int m_maxVoices{ MAX_VOICES };
+    int m_stolenVoices{ 0 };
+    int m_rejectedVoices{ 0 };
     bool m_audioEnabled{ true };
     std::unordered_map<int, SoundChannelPtr> m_channels;
 };
@@ -30,7 +30,7 @@
 class SoundSource : public LuaObject
 {
 protected:
-    SoundSource(uint sourceId) : m_sourceId(sourceId) {}
+    SoundSource(uint sourceId) : m_sourceId(sourceId), m_channel(0) {}
 
 public:
     enum FadeState { NoFading, FadingOn, FadingOff };
@@ -57,13 +57,16 @@ public:
     std::string getName() { return m_name; }
     uchar getChannel() { return m_channel; }
     float getGain() { return m_gain; }
+    int getPriority() { return m_priority; }
 
 protected:
     void setBuffer(const SoundBufferPtr& buffer);
     void setChannel(uchar channel) { m_channel = channel; }
+    void setPriority(int priority) { m_priority = priority; }
 
     virtual void update();
     friend class SoundManager;
+    friend class SoundChannel;
     friend class CombinedSoundSource;
 
     uint m_sourceId;
@@ -75,6 +78,7 @@ protected:
     float m_fadeTime;
     float m_fadeGain;
     float m_gain;
+    int m_priority{ 0 };
 };
 
 #endif
@@ -22,168 +22,42 @@
 
 #include "streamsoundsource.h"
 #include "soundbuffer.h"
-#include "soundfile.h"
-
-#include <framework/util/databuffer.h>
-#include <boost/concept_check.hpp>
 
 StreamSoundSource::StreamSoundSource()
 {
-    for(auto& buffer : m_buffers)
+    m_stream = new AudioThread::Stream;
+    m_stream->sourceId = m_sourceId;
+    for(auto& buffer : m_stream->buffers)
         buffer = SoundBufferPtr(new SoundBuffer);
-    m_downMix = NoDownMix;
+    g_audio.post(AudioThread::AddStream, m_stream);
 }
 
 StreamSoundSource::~StreamSoundSource()
 {
-    stop();
+    // the audio thread may still be queueing buffers, it deletes the source itself
+    g_audio.post(AudioThread::ReleaseStream, m_stream);
+    m_sourceId = 0;
 }
 
 void StreamSoundSource::setSoundFile(const SoundFilePtr& soundFile)
 {
-    m_soundFile = soundFile;
-    if(m_waitingFile) {
-        m_waitingFile = false;
-        play();
-    }
+    g_audio.post(m_stream, soundFile);
 }
 
 void StreamSoundSource::play()
 {
+    // playback starts as soon as the sound file is there
     m_playing = true;
-
-    if(!m_soundFile) {
-        m_waitingFile = true;
-        return;
-    }
-
-    if(m_eof) {
-        m_soundFile->reset();
-        m_eof = false;
-    }
-
-    queueBuffers();
-
-    SoundSource::play();
+    g_audio.post(AudioThread::PlayStream, m_stream, ++m_serial);
 }
 
 void StreamSoundSource::stop()
 {
     m_playing = false;
-
-    if(m_waitingFile)
-        return;
-
-    SoundSource::stop();
-    unqueueBuffers();
-}
-
-void StreamSoundSource::queueBuffers()
-{
-    int queued;
-    alGetSourcei(m_sourceId, AL_BUFFERS_QUEUED, &queued);
-    for(int i = 0; i < STREAM_FRAGMENTS - queued; ++i) {
-        if(!fillBufferAndQueue(m_buffers[i]->getBufferId()))
-            break;
-    }
-}
-
-void StreamSoundSource::unqueueBuffers()
-{
-    int queued;
-    alGetSourcei(m_sourceId, AL_BUFFERS_QUEUED, &queued);
-    for(int i = 0; i < queued; ++i) {
-        uint buffer;
-        alSourceUnqueueBuffers(m_sourceId, 1, &buffer);
-    }
-}
-
-void StreamSoundSource::update()
-{
-    if(m_waitingFile)
-        return;
-
-    SoundSource::update();
-
-    int processed = 0;
-    alGetSourcei(m_sourceId, AL_BUFFERS_PROCESSED, &processed);
-    for(int i = 0; i < processed; ++i) {
-        uint buffer;
-        alSourceUnqueueBuffers(m_sourceId, 1, &buffer);
-        //SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
-
-        if(!fillBufferAndQueue(buffer))
-            break;
-    }
-
-    if(!isBuffering() && m_playing) {
-        if(!m_looping && m_eof) {
-            stop();
-        } else if(processed == 0) {
-            g_logger.traceError("audio buffer underrun");
-            play();
-        } else if(m_looping) {
-            play();
-        }
-    }
-}
-
-bool StreamSoundSource::fillBufferAndQueue(uint buffer)
-{
-    if(m_waitingFile)
-        return false;
-
-    // fill buffer
-    static DataBuffer<char> bufferData(2 * STREAM_FRAGMENT_SIZE);
-    ALenum format = m_soundFile->getSampleFormat();
-
-    int maxRead = STREAM_FRAGMENT_SIZE;
-    if(m_downMix != NoDownMix)
-        maxRead *= 2;
-
-    int bytesRead = 0;
-    do {
-        bytesRead += m_soundFile->read(&bufferData[bytesRead], maxRead - bytesRead);
-
-        // end of sound file
-        if(bytesRead < maxRead) {
-            if(m_looping)
-                m_soundFile->reset();
-            else {
-                m_eof = true;
-                break;
-            }
-        }
-    } while(bytesRead < maxRead);
-
-    if(bytesRead > 0) {
-        if(m_downMix != NoDownMix) {
-            if(format == AL_FORMAT_STEREO16) {
-                assert(bytesRead % 2 == 0);
-                bytesRead /= 2;
-                auto data = (uint16_t*)bufferData.data();
-                for(int i = 0; i < bytesRead / 2; i++)
-                    data[i] = data[2 * i + (m_downMix == DownMixLeft ? 0 : 1)];
-                format = AL_FORMAT_MONO16;
-            }
-        }
-
-        alBufferData(buffer, format, &bufferData[0], bytesRead, m_soundFile->getRate());
-        ALenum err = alGetError();
-        if(err != AL_NO_ERROR)
-            g_logger.error(stdext::format("unable to refill audio buffer for '%s': %s", m_soundFile->getName(), alGetString(err)));
-
-        alSourceQueueBuffers(m_sourceId, 1, &buffer);
-        err = alGetError();
-        if(err != AL_NO_ERROR)
-            g_logger.error(stdext::format("unable to queue audio buffer for '%s': %s", m_soundFile->getName(), alGetString(err)));
-    }
-
-    // return false if there aren't more buffers to fill
-    return (bytesRead >= STREAM_FRAGMENT_SIZE && !m_eof);
+    g_audio.post(AudioThread::StopStream, m_stream);
 }
 
 void StreamSoundSource::downMix(DownMix downMix)
 {
-    m_downMix = downMix;
+    g_audio.post(AudioThread::SetDownMix, m_stream, downMix == NoDownMix ? -1 : (downMix == DownMixLeft ? 0 : 1));
 }
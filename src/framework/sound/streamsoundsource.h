@@ -24,15 +24,11 @@
 #define STREAMSOUNDSOURCE_H
 
 #include "soundsource.h"
+#include "audiothread.h"
 
+/// Sound source fed by the audio thread, see AudioThread
 class StreamSoundSource : public SoundSource
 {
-    enum {
-        STREAM_BUFFER_SIZE = 1024 * 400,
-        STREAM_FRAGMENTS = 4,
-        STREAM_FRAGMENT_SIZE = STREAM_BUFFER_SIZE / STREAM_FRAGMENTS
-    };
-
 public:
     enum DownMix { NoDownMix, DownMixLeft, DownMixRight };
 
@@ -42,26 +38,16 @@ public:
     void play() override;
     void stop() override;
 
-    bool isPlaying() override { return m_playing; }
+    bool isPlaying() override { return m_playing && m_stream->finished != m_serial; }
 
     void setSoundFile(const SoundFilePtr& soundFile);
 
     void downMix(DownMix downMix);
 
-    void update() override;
-
 private:
-    void queueBuffers();
-    void unqueueBuffers();
-    bool fillBufferAndQueue(uint buffer);
-
-    SoundFilePtr m_soundFile;
-    std::array<SoundBufferPtr, STREAM_FRAGMENTS> m_buffers;
-    DownMix m_downMix;
-    bool m_looping{ false },
-        m_playing{ false },
-        m_eof{ false },
-        m_waitingFile{ false };
+    AudioThread::Stream* m_stream;
+    uint m_serial{ 0 };
+    bool m_playing{ false };
 };
 
 #endif
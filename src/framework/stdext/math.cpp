@@ -23,11 +23,39 @@
 #include <cmath>
 #include <random>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(disable:4267) // '?' : conversion from 'A' to 'B', possible loss of data
 #endif
 
 namespace stdext {
+    bool cpu_supports_avx2()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if(info[0] < 7)
+            return false;
+
+        // the os must also save the ymm registers
+        __cpuid(info, 1);
+        if(!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
     uint32_t adler32(const uint8_t* buffer, size_t size)
     {
         size_t a = 1, b = 0;
@@ -48,6 +48,9 @@ namespace stdext {
 
     uint32_t adler32(const uint8_t* buffer, size_t size);
 
+    // whether avx2 code can run here, checked once by the vector kernels that have an avx2 path
+    bool cpu_supports_avx2();
+
     long random_range(long min, long max);
     float random_range(float min, float max);
 
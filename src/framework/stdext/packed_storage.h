@@ -40,8 +40,22 @@ namespace stdext {
 
     public:
         packed_storage() : m_values(nullptr), m_size(0) {}
+        packed_storage(const packed_storage& other) : m_values(nullptr), m_size(0) { *this = other; }
         ~packed_storage() { delete[] m_values; }
 
+        packed_storage& operator=(const packed_storage& other)
+        {
+            if(this == &other)
+                return *this;
+
+            value_pair* values = other.m_size > 0 ? new value_pair[other.m_size] : nullptr;
+            std::copy(other.m_values, other.m_values + other.m_size, values);
+            delete[] m_values;
+            m_values = values;
+            m_size = other.m_size;
+            return *this;
+        }
+
         template<typename T>
         void set(Key id, const T& value)
         {
@@ -69,6 +69,15 @@ namespace stdext {
         return num;
     }
 
+    uint64_t fnv1a_hash(const std::string& str, uint64_t hash)
+    {
+        for(const char c : str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
     bool is_valid_utf8(const std::string& src)
     {
         auto bytes = (const unsigned char*)src.c_str();
@@ -41,6 +41,8 @@ namespace stdext {
 
     std::string dec_to_hex(uint64_t num);
     uint64_t hex_to_dec(const std::string& str);
+    /// FNV-1a, stable across runs and platforms unlike std::hash, chain calls by passing the previous hash
+    uint64_t fnv1a_hash(const std::string& str, uint64_t hash = 14695981039346656037ULL);
     void tolower(std::string& str);
     void toupper(std::string& str);
     void trim(std::string& str);
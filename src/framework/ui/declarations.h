@@ -37,9 +37,11 @@ class UIAnchor;
 class UIAnchorGroup;
 class UIAnchorLayout;
 class UIParticles;
+class UIVirtualList;
 
 using UIWidgetPtr = stdext::shared_object_ptr<UIWidget>;
 using UIParticlesPtr = stdext::shared_object_ptr<UIParticles>;
+using UIVirtualListPtr = stdext::shared_object_ptr<UIVirtualList>;
 using UITextEditPtr = stdext::shared_object_ptr<UITextEdit>;
 using UILayoutPtr = stdext::shared_object_ptr<UILayout>;
 using UIBoxLayoutPtr = stdext::shared_object_ptr<UIBoxLayout>;
@@ -52,6 +52,7 @@ void UIManager::terminate()
     m_hoveredWidget = nullptr;
     m_pressedWidget = nullptr;
     m_styles.clear();
+    m_widgetPrototypes.clear();
     m_destroyedWidgets.clear();
     m_checkEvent = nullptr;
 }
@@ -313,6 +314,7 @@ void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
 void UIManager::clearStyles()
 {
     m_styles.clear();
+    m_widgetPrototypes.clear();
 }
 
 bool UIManager::importStyle(std::string file)
@@ -372,6 +374,7 @@ void UIManager::importStyleFromOTML(const OTMLNodePtr& styleNode)
         style->merge(styleNode);
         style->setTag(name);
         m_styles[name] = style;
+        m_widgetPrototypes.clear();
     }
 }
 
@@ -440,6 +443,31 @@ UIWidgetPtr UIManager::createWidget(const std::string& styleName, const UIWidget
 
 UIWidgetPtr UIManager::createWidgetFromOTML(const OTMLNodePtr& widgetNode, const UIWidgetPtr& parent)
 {
+    // widgets that don't customize their style are created from its prototype
+    if(!widgetNode->hasChildren()) {
+        // held while creating, as lua may import styles meanwhile and reset the prototypes
+        const WidgetPrototypePtr prototype = getWidgetPrototype(widgetNode->tag());
+
+        OTMLNodePtr styleNode = prototype->style->clone();
+        styleNode->setTag(widgetNode->tag());
+        styleNode->setSource(widgetNode->source());
+
+        auto widget = g_lua.callGlobalField<UIWidgetPtr>(prototype->className, "create");
+        if(!widget)
+            stdext::throw_exception(stdext::format("unable to create widget of type '%s'", prototype->className));
+        if(parent)
+            parent->addChild(widget);
+
+        widget->callLuaField("onCreate");
+        widget->setStyleFromNode(styleNode);
+
+        for(const OTMLNodePtr& childNode : prototype->children)
+            createWidgetFromOTML(childNode, widget);
+
+        widget->callLuaField("onSetup");
+        return widget;
+    }
+
     OTMLNodePtr originalStyleNode = getStyle(widgetNode->tag());
     if(!originalStyleNode)
         stdext::throw_exception(stdext::format("'%s' is not a defined style", widgetNode->tag()));
@@ -471,3 +499,29 @@ UIWidgetPtr UIManager::createWidgetFromOTML(const OTMLNodePtr& widgetNode, const
     widget->callLuaField("onSetup");
     return widget;
 }
+
+UIManager::WidgetPrototypePtr UIManager::getWidgetPrototype(const std::string& styleName)
+{
+    const auto it = m_widgetPrototypes.find(styleName);
+    if(it != m_widgetPrototypes.end())
+        return it->second;
+
+    const OTMLNodePtr originalStyleNode = getStyle(styleName);
+    if(!originalStyleNode)
+        stdext::throw_exception(stdext::format("'%s' is not a defined style", styleName));
+
+    const auto prototype = std::make_shared<WidgetPrototype>();
+    prototype->style = originalStyleNode->clone();
+    prototype->className = prototype->style->valueAt("__class");
+
+    // child widgets are created from their own styles, so they are kept apart and never copied
+    for(const OTMLNodePtr& childNode : prototype->style->children()) {
+        if(!childNode->isUnique()) {
+            prototype->children.push_back(childNode);
+            prototype->style->removeChild(childNode);
+        }
+    }
+
+    m_widgetPrototypes[styleName] = prototype;
+    return prototype;
+}
@@ -87,6 +87,20 @@ private:
     bool m_hoverUpdateScheduled{ false },
         m_drawDebugBoxes{ false };
     std::unordered_map<std::string, OTMLNodePtr> m_styles;
+
+    // what createWidget needs from a style, resolved once instead of for every widget
+    struct WidgetPrototype
+    {
+        std::string className;
+        OTMLNodePtr style; // without the child widgets
+        OTMLNodeList children;
+    };
+
+    using WidgetPrototypePtr = std::shared_ptr<const WidgetPrototype>;
+
+    WidgetPrototypePtr getWidgetPrototype(const std::string& styleName);
+
+    std::unordered_map<std::string, WidgetPrototypePtr> m_widgetPrototypes;
     UIWidgetList m_destroyedWidgets;
     ScheduledEventPtr m_checkEvent;
 };
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "uivirtuallist.h"
+#include "uimanager.h"
+#include <framework/core/application.h>
+#include <framework/core/eventdispatcher.h>
+
+UIVirtualList::UIVirtualList()
+{
+    setClipping(true);
+}
+
+void UIVirtualList::addItem(const std::string& text)
+{
+    const bool followBottom = m_autoScroll && isScrolledToBottom();
+
+    m_items.resize(m_itemCount);
+    m_items.push_back(text);
+    if(!m_itemHeights.empty())
+        m_itemHeights.push_back(m_rowHeight);
+    m_itemCount++;
+    m_rowOffsetsDirty = true;
+
+    if(m_maxItems > 0 && m_itemCount > m_maxItems)
+        removeFrontItems(m_itemCount - m_maxItems);
+
+    if(followBottom)
+        m_scrollOffset = getMaxScrollOffset();
+    scheduleUpdate();
+}
+
+void UIVirtualList::setItems(const std::vector<std::string>& items)
+{
+    m_items.assign(items.begin(), items.end());
+    m_itemHeights.clear();
+    m_itemCount = m_items.size();
+    m_rowOffsetsDirty = true;
+
+    if(m_maxItems > 0 && m_itemCount > m_maxItems)
+        removeFrontItems(m_itemCount - m_maxItems);
+
+    m_rowsDirty = true;
+    scheduleUpdate();
+}
+
+void UIVirtualList::setItemText(int index, const std::string& text)
+{
+    index--;
+    if(index < 0 || index >= m_itemCount)
+        return;
+
+    m_items.resize(m_itemCount);
+    m_items[index] = text;
+
+    const auto it = m_rows.find(index);
+    if(it != m_rows.end())
+        bindRow(it->second, index);
+}
+
+void UIVirtualList::clearItems()
+{
+    m_items.clear();
+    m_itemHeights.clear();
+    m_itemCount = 0;
+    m_scrollOffset = 0;
+    m_rowOffsetsDirty = true;
+    m_rowsDirty = true;
+    scheduleUpdate();
+}
+
+std::string UIVirtualList::getItemText(int index)
+{
+    index--;
+    if(index < 0 || index >= (int)m_items.size())
+        return std::string();
+    return m_items[index];
+}
+
+void UIVirtualList::setItemCount(int count)
+{
+    count = std::max<int>(count, 0);
+    if(count < (int)m_items.size())
+        m_items.resize(count);
+    if(!m_itemHeights.empty())
+        m_itemHeights.resize(count, m_rowHeight);
+    m_itemCount = count;
+    m_rowOffsetsDirty = true;
+
+    // the items of a lua model may have changed as well
+    m_rowsDirty = true;
+    scheduleUpdate();
+}
+
+void UIVirtualList::setItemHeight(int index, int height)
+{
+    index--;
+    if(index < 0 || index >= m_itemCount)
+        return;
+
+    // rows keep the default height until one of them is set
+    if(m_itemHeights.empty())
+        m_itemHeights.assign(m_itemCount, m_rowHeight);
+    m_itemHeights[index] = std::max<int>(height, 0);
+    m_rowOffsetsDirty = true;
+    scheduleUpdate();
+}
+
+void UIVirtualList::setRowStyle(const std::string& rowStyle)
+{
+    if(rowStyle == m_rowStyle)
+        return;
+
+    m_rowStyle = rowStyle;
+    clearRows();
+}
+
+void UIVirtualList::setRowHeight(int rowHeight)
+{
+    m_rowHeight = std::max<int>(rowHeight, 1);
+    m_rowOffsetsDirty = true;
+    scheduleUpdate();
+}
+
+void UIVirtualList::setMaxItems(int maxItems)
+{
+    m_maxItems = std::max<int>(maxItems, 0);
+    if(m_maxItems > 0 && m_itemCount > m_maxItems) {
+        removeFrontItems(m_itemCount - m_maxItems);
+        scheduleUpdate();
+    }
+}
+
+void UIVirtualList::setScrollOffset(int scrollOffset)
+{
+    scrollOffset = std::max<int>(std::min<int>(scrollOffset, getMaxScrollOffset()), 0);
+    if(scrollOffset == m_scrollOffset)
+        return;
+
+    m_scrollOffset = scrollOffset;
+    m_reportedScrollOffset = scrollOffset;
+    scheduleUpdate();
+    callLuaField("onScrollChange", m_scrollOffset);
+}
+
+void UIVirtualList::scrollToItem(int index)
+{
+    index--;
+    if(index < 0 || index >= m_itemCount)
+        return;
+
+    const int top = rowOffset(index);
+    const int bottom = top + rowHeight(index);
+    const int height = getPaddingRect().height();
+    if(top < m_scrollOffset)
+        setScrollOffset(top);
+    else if(bottom > m_scrollOffset + height)
+        setScrollOffset(bottom - height);
+}
+
+int UIVirtualList::getItemHeight(int index)
+{
+    index--;
+    if(index < 0 || index >= m_itemCount)
+        return 0;
+    return rowHeight(index);
+}
+
+int UIVirtualList::getItemOffset(int index)
+{
+    index--;
+    if(index < 0 || index > m_itemCount)
+        return 0;
+    return rowOffset(index);
+}
+
+int UIVirtualList::getItemAt(int y)
+{
+    if(m_itemCount == 0)
+        return 0;
+    return rowAt(y) + 1;
+}
+
+int UIVirtualList::getMaxScrollOffset()
+{
+    return std::max<int>(getContentHeight() - getPaddingRect().height(), 0);
+}
+
+int UIVirtualList::getContentHeight()
+{
+    return rowOffset(m_itemCount);
+}
+
+UIWidgetPtr UIVirtualList::getRowWidget(int index)
+{
+    const auto it = m_rows.find(index - 1);
+    if(it != m_rows.end())
+        return it->second;
+    return nullptr;
+}
+
+void UIVirtualList::onStyleApply(const std::string& styleName, const OTMLNodePtr& styleNode)
+{
+    UIWidget::onStyleApply(styleName, styleNode);
+
+    for(const OTMLNodePtr& node : styleNode->children()) {
+        if(node->tag() == "row-style")
+            setRowStyle(node->value());
+        else if(node->tag() == "row-height")
+            setRowHeight(node->value<int>());
+        else if(node->tag() == "overscan")
+            setOverscan(node->value<int>());
+        else if(node->tag() == "max-items")
+            setMaxItems(node->value<int>());
+        else if(node->tag() == "scroll-step")
+            setScrollStep(node->value<int>());
+        else if(node->tag() == "auto-scroll")
+            setAutoScroll(node->value<bool>());
+    }
+}
+
+void UIVirtualList::onGeometryChange(const Rect& oldRect, const Rect& newRect)
+{
+    // rows are placed by the list itself, they must not be bound to its rect
+    if(m_autoScroll && oldRect.height() != newRect.height() && m_scrollOffset + oldRect.height() >= getContentHeight())
+        m_scrollOffset = getMaxScrollOffset();
+    updateRows();
+
+    callLuaField("onGeometryChange", oldRect, newRect);
+
+    g_app.repaint();
+}
+
+bool UIVirtualList::onMouseWheel(const Point& mousePos, Fw::MouseWheelDirection direction)
+{
+    if(UIWidget::onMouseWheel(mousePos, direction))
+        return true;
+
+    const int step = m_scrollStep > 0 ? m_scrollStep : 3 * m_rowHeight;
+    setScrollOffset(m_scrollOffset + (direction == Fw::MouseWheelUp ? -step : step));
+    return true;
+}
+
+int UIVirtualList::rowOffset(int index)
+{
+    if(m_itemHeights.empty())
+        return index * m_rowHeight;
+
+    updateRowOffsets();
+    return m_rowOffsets[index];
+}
+
+int UIVirtualList::rowAt(int y)
+{
+    int index;
+    if(m_itemHeights.empty()) {
+        index = y / m_rowHeight;
+    } else {
+        updateRowOffsets();
+        index = std::upper_bound(m_rowOffsets.begin(), m_rowOffsets.end(), y) - m_rowOffsets.begin() - 1;
+    }
+    return std::max<int>(std::min<int>(index, m_itemCount - 1), 0);
+}
+
+void UIVirtualList::removeFrontItems(int count)
+{
+    // keep the content in view still while the oldest items are dropped
+    m_scrollOffset = std::max<int>(m_scrollOffset - rowOffset(count), 0);
+
+    m_items.erase(m_items.begin(), m_items.begin() + std::min<int>(count, m_items.size()));
+    if(!m_itemHeights.empty())
+        m_itemHeights.erase(m_itemHeights.begin(), m_itemHeights.begin() + count);
+    m_itemCount -= count;
+    m_rowOffsetsDirty = true;
+
+    // every row now shows a different item
+    m_rowsDirty = true;
+}
+
+void UIVirtualList::bindRow(const UIWidgetPtr& row, int index)
+{
+    if(index < (int)m_items.size())
+        row->setText(m_items[index]);
+    callLuaField("onUpdateRow", row, index + 1);
+}
+
+void UIVirtualList::updateRowOffsets()
+{
+    if(!m_rowOffsetsDirty)
+        return;
+    m_rowOffsetsDirty = false;
+
+    m_rowOffsets.resize(m_itemCount + 1);
+    m_rowOffsets[0] = 0;
+    for(int i = 0; i < m_itemCount; ++i)
+        m_rowOffsets[i + 1] = m_rowOffsets[i] + m_itemHeights[i];
+}
+
+void UIVirtualList::scheduleUpdate()
+{
+    // many items are usually added at once, lay out the rows only once for all of them
+    if(m_updateScheduled)
+        return;
+
+    m_updateScheduled = true;
+    const auto self = static_self_cast<UIVirtualList>();
+    g_dispatcher.addEvent([self] {
+        self->m_updateScheduled = false;
+        self->updateRows();
+    });
+}
+
+void UIVirtualList::updateRows()
+{
+    if(isDestroyed())
+        return;
+
+    const Rect paddingRect = getPaddingRect();
+    m_scrollOffset = std::max<int>(std::min<int>(m_scrollOffset, getMaxScrollOffset()), 0);
+
+    int first = 0;
+    int last = -1;
+    if(m_itemCount > 0 && paddingRect.height() > 0) {
+        first = std::max<int>(rowAt(m_scrollOffset) - m_overscan, 0);
+        last = std::min<int>(rowAt(m_scrollOffset + paddingRect.height() - 1) + m_overscan, m_itemCount - 1);
+    }
+
+    // lua may change the list while rows are updated, that schedules another update
+    const bool rowsDirty = m_rowsDirty;
+    m_rowsDirty = false;
+
+    for(auto it = m_rows.begin(); it != m_rows.end();) {
+        if(it->first < first || it->first > last) {
+            m_freeRows.push_back(it->second);
+            it = m_rows.erase(it);
+        } else
+            ++it;
+    }
+
+    for(int index = first; index <= last; ++index) {
+        UIWidgetPtr row;
+        const auto it = m_rows.find(index);
+        if(it != m_rows.end()) {
+            row = it->second;
+            if(rowsDirty)
+                bindRow(row, index);
+        } else {
+            row = takeRow();
+            if(!row)
+                break;
+            m_rows[index] = row;
+            bindRow(row, index);
+        }
+
+        if(isDestroyed())
+            return;
+
+        // lua shrank the list, the rows left over are dropped by the update it scheduled
+        if(index >= m_itemCount)
+            break;
+
+        // shown before placing it, a hidden widget is bound to its parent rect when shown
+        row->setVisible(true);
+        row->setRect(Rect(paddingRect.left(), paddingRect.top() + rowOffset(index) - m_scrollOffset, paddingRect.width(), rowHeight(index)));
+    }
+
+    for(const UIWidgetPtr& row : m_freeRows)
+        row->setVisible(false);
+
+    // lets a scrollbar follow content and offset changes made without setScrollOffset
+    const int maxScrollOffset = getMaxScrollOffset();
+    if(maxScrollOffset != m_reportedMaxScrollOffset) {
+        m_reportedMaxScrollOffset = maxScrollOffset;
+        callLuaField("onScrollRangeChange", maxScrollOffset);
+    }
+    if(m_scrollOffset != m_reportedScrollOffset && !isDestroyed()) {
+        m_reportedScrollOffset = m_scrollOffset;
+        callLuaField("onScrollChange", m_scrollOffset);
+    }
+}
+
+void UIVirtualList::clearRows()
+{
+    for(auto& it : m_rows)
+        m_freeRows.push_back(it.second);
+    m_rows.clear();
+
+    for(const UIWidgetPtr& row : m_freeRows)
+        row->destroy();
+    m_freeRows.clear();
+
+    scheduleUpdate();
+}
+
+UIWidgetPtr UIVirtualList::takeRow()
+{
+    if(!m_freeRows.empty()) {
+        UIWidgetPtr row = m_freeRows.back();
+        m_freeRows.pop_back();
+        return row;
+    }
+
+    const UIWidgetPtr row = g_ui.createWidget(m_rowStyle, static_self_cast<UIWidget>());
+    if(row)
+        row->breakAnchors();
+    return row;
+}
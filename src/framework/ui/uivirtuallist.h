@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UIVIRTUALLIST_H
+#define UIVIRTUALLIST_H
+
+#include <framework/ui/uiwidget.h>
+
+// Scrollable list that only keeps widgets for the rows that are visible,
+// rows scrolled out of view are recycled to show other items.
+class UIVirtualList : public UIWidget
+{
+public:
+    UIVirtualList();
+
+    void addItem(const std::string& text);
+    void setItems(const std::vector<std::string>& items);
+    void setItemText(int index, const std::string& text);
+    void clearItems();
+    std::string getItemText(int index);
+
+    void setItemCount(int count);
+    void setItemHeight(int index, int height);
+    void setRowStyle(const std::string& rowStyle);
+    void setRowHeight(int rowHeight);
+    void setOverscan(int overscan) { m_overscan = std::max<int>(overscan, 0); scheduleUpdate(); }
+    void setMaxItems(int maxItems);
+    void setScrollStep(int scrollStep) { m_scrollStep = scrollStep; }
+    void setAutoScroll(bool autoScroll) { m_autoScroll = autoScroll; }
+    void setScrollOffset(int scrollOffset);
+
+    void scrollToItem(int index);
+    void scrollToBottom() { setScrollOffset(getMaxScrollOffset()); }
+    void refresh() { m_rowsDirty = true; scheduleUpdate(); }
+
+    int getItemCount() { return m_itemCount; }
+    int getItemHeight(int index);
+    int getItemOffset(int index);
+    int getItemAt(int y);
+    std::string getRowStyle() { return m_rowStyle; }
+    int getRowHeight() { return m_rowHeight; }
+    int getOverscan() { return m_overscan; }
+    int getMaxItems() { return m_maxItems; }
+    int getScrollStep() { return m_scrollStep; }
+    int getScrollOffset() { return m_scrollOffset; }
+    int getMaxScrollOffset();
+    int getContentHeight();
+    UIWidgetPtr getRowWidget(int index);
+
+    bool isAutoScroll() { return m_autoScroll; }
+    bool isScrolledToBottom() { return m_scrollOffset >= getMaxScrollOffset(); }
+
+protected:
+    void onStyleApply(const std::string& styleName, const OTMLNodePtr& styleNode) override;
+    void onGeometryChange(const Rect& oldRect, const Rect& newRect) override;
+    bool onMouseWheel(const Point& mousePos, Fw::MouseWheelDirection direction) override;
+
+private:
+    int rowOffset(int index);
+    int rowHeight(int index) { return m_itemHeights.empty() ? m_rowHeight : m_itemHeights[index]; }
+    int rowAt(int y);
+    void removeFrontItems(int count);
+    void bindRow(const UIWidgetPtr& row, int index);
+    void updateRowOffsets();
+    void scheduleUpdate();
+    void updateRows();
+    void clearRows();
+    UIWidgetPtr takeRow();
+
+    std::deque<std::string> m_items;
+    std::deque<int> m_itemHeights;
+    std::vector<int> m_rowOffsets;
+    std::unordered_map<int, UIWidgetPtr> m_rows;
+    std::vector<UIWidgetPtr> m_freeRows;
+    std::string m_rowStyle{ "UILabel" };
+    int m_itemCount{ 0 };
+    int m_rowHeight{ 14 };
+    int m_overscan{ 2 };
+    int m_maxItems{ 0 };
+    int m_scrollStep{ 0 };
+    int m_scrollOffset{ 0 };
+    int m_reportedScrollOffset{ 0 };
+    int m_reportedMaxScrollOffset{ 0 };
+    bool m_autoScroll{ false };
+    bool m_rowOffsetsDirty{ false };
+    bool m_rowsDirty{ false };
+    bool m_updateScheduled{ false };
+};
+
+#endif
@@ -519,6 +519,7 @@ void UIWidget::mergeStyle(const OTMLNodePtr& styleNode)
     m_style->merge(styleNode);
     m_style->setTag(name);
     m_style->setSource(source);
+    parseStateStyles();
     updateStyle();
 }
 
@@ -912,6 +913,7 @@ void UIWidget::setStyle(const std::string& styleName)
     styleNode = styleNode->clone();
     applyStyle(styleNode);
     m_style = styleNode;
+    parseStateStyles();
     updateStyle();
 }
 
@@ -919,6 +921,7 @@ void UIWidget::setStyleFromNode(const OTMLNodePtr& styleNode)
 {
     applyStyle(styleNode);
     m_style = styleNode;
+    parseStateStyles();
     updateStyle();
 }
 
@@ -1424,6 +1427,23 @@ void UIWidget::updateStyle()
     if(!m_style)
         return;
 
+    // checks for states combination
+    bool changed = !m_stateStylesApplied;
+    for(size_t i = 0; i < m_stateStyles.size(); ++i) {
+        const StateStyle& stateStyle = m_stateStyles[i];
+        const bool match = (m_states & stateStyle.onStates) == stateStyle.onStates && !(m_states & stateStyle.offStates);
+        if(match != m_matchedStateStyles[i]) {
+            m_matchedStateStyles[i] = match;
+            changed = true;
+        }
+    }
+
+    // the same state styles are already applied
+    if(!changed)
+        return;
+
+    m_stateStylesApplied = true;
+
     OTMLNodePtr newStateStyle = OTMLNode::create();
 
     // copy only the changed styles from default style
@@ -1434,31 +1454,10 @@ void UIWidget::updateStyle()
         }
     }
 
-    // checks for states combination
-    for(const OTMLNodePtr& style : m_style->children()) {
-        if(stdext::starts_with(style->tag(), "$")) {
-            std::string statesStr = style->tag().substr(1);
-            std::vector<std::string> statesSplit = stdext::split(statesStr, " ");
-
-            bool match = true;
-            for(std::string stateStr : statesSplit) {
-                if(stateStr.length() == 0)
-                    continue;
-
-                const bool notstate = (stateStr[0] == '!');
-                if(notstate)
-                    stateStr = stateStr.substr(1);
-
-                const bool stateOn = hasState(Fw::translateState(stateStr));
-                if((!notstate && !stateOn) || (notstate && stateOn))
-                    match = false;
-            }
-
-            // merge states styles
-            if(match) {
-                newStateStyle->merge(style);
-            }
-        }
+    // merge states styles
+    for(size_t i = 0; i < m_stateStyles.size(); ++i) {
+        if(m_matchedStateStyles[i])
+            newStateStyle->merge(m_stateStyles[i].node);
     }
 
     //TODO: prevent setting already set proprieties
@@ -1467,6 +1466,68 @@ void UIWidget::updateStyle()
     m_stateStyle = newStateStyle;
 }
 
+namespace {
+    struct StateSelector
+    {
+        int onStates{ 0 };
+        int offStates{ 0 };
+        bool valid{ true };
+    };
+
+    // the same selectors are used by many styles and widgets, so each one is parsed once
+    const StateSelector& parseStateSelector(const std::string& tag)
+    {
+        static std::unordered_map<std::string, StateSelector> selectors;
+        const auto it = selectors.find(tag);
+        if(it != selectors.end())
+            return it->second;
+
+        StateSelector selector;
+        for(std::string stateStr : stdext::split(tag.substr(1), " ")) {
+            if(stateStr.length() == 0)
+                continue;
+
+            const bool notstate = (stateStr[0] == '!');
+            if(notstate)
+                stateStr = stateStr.substr(1);
+
+            // an unknown state is never on
+            const Fw::WidgetState state = Fw::translateState(stateStr);
+            if(state == Fw::InvalidState) {
+                if(!notstate)
+                    selector.valid = false;
+                continue;
+            }
+
+            if(notstate)
+                selector.offStates |= state;
+            else
+                selector.onStates |= state;
+        }
+        return selectors.emplace(tag, selector).first->second;
+    }
+}
+
+void UIWidget::parseStateStyles()
+{
+    m_stateStyles.clear();
+    m_matchedStateStyles.clear();
+    m_stateStylesApplied = false;
+
+    if(!m_style)
+        return;
+
+    for(const OTMLNodePtr& style : m_style->children()) {
+        if(!stdext::starts_with(style->tag(), "$"))
+            continue;
+
+        const StateSelector& selector = parseStateSelector(style->tag());
+        if(selector.valid)
+            m_stateStyles.push_back({ selector.onStates, selector.offStates, style });
+    }
+    m_matchedStateStyles.resize(m_stateStyles.size(), false);
+}
+
 void UIWidget::onStyleApply(const std::string&, const OTMLNodePtr& styleNode)
 {
     if(m_destroyed)
@@ -172,10 +172,22 @@ private:
     void updateStates();
     void updateChildrenIndexStates();
     void updateStyle();
+    void parseStateStyles();
+
+    // $state selector of the style, parsed once when the style is set
+    struct StateStyle
+    {
+        int onStates;
+        int offStates;
+        OTMLNodePtr node;
+    };
 
     bool m_updateStyleScheduled{ false };
     bool m_firstOnStyle{ true };
+    bool m_stateStylesApplied{ false };
     OTMLNodePtr m_stateStyle;
+    std::vector<StateStyle> m_stateStyles;
+    std::vector<bool> m_matchedStateStyles;
     int m_states;
 
     // event processing
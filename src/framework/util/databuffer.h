@@ -99,6 +99,14 @@ public:
         m_buffer[m_size - 1] = v;
     }
 
+    void append(const T* data, uint n)
+    {
+        const uint pos = m_size;
+        grow(m_size + n);
+        for(uint i = 0; i < n; ++i)
+            m_buffer[pos + i] = data[i];
+    }
+
     DataBuffer& operator<<(const T& t) { add(t); return *this; }
 
 private: